@@ -24,6 +24,7 @@
  * |----------------------------------------------------------------------
  */
 #include "gsm.h"
+#include "gsm_pdu.h"
 #include "math.h"
 
 /******************************************************************************/
@@ -71,6 +72,21 @@ typedef struct {
 #define GSM_RING                            FROMMEM("RING\r\n")
 #define GSM_CRLF                            FROMMEM("\r\n")
 
+#define CONN_SEGMENT_SIZE_DEFAULT           1460
+#define CONN_SEGMENT_SIZE_MIN               128
+#define CONN_SEGMENT_SIZE_STEP              128
+#define CONN_SEGMENT_SIZE(GSM, conn)        ((conn)->SegmentSize ? (conn)->SegmentSize : (GSM)->ConnMaxSegmentSize)
+#define CONN_SEGMENT_LIMIT(GSM, conn)       ((conn)->SegmentLimit ? (conn)->SegmentLimit : (GSM)->ConnMaxSegmentSize)
+#define CONN_READ_SIZE_MAX                  1460
+#define CONN_QSEND_ACK_TRIES                (GSM_CONN_QSEND_ACK_TIMEOUT / 200 ? GSM_CONN_QSEND_ACK_TIMEOUT / 200 : 1)
+#define SMS_QUEUE_RETRY_DELAY               2000
+#define HTTP_DATA_SIZE_MAX                  319488
+#define HTTP_DATA_TIME_MIN                  5000
+#define HTTP_DATA_TIME_MAX                  120000
+#define TRANSPARENT_CLOSED                  FROMMEM("\r\nCLOSED\r\n")
+#define TRANSPARENT_CLOSED_LENGTH           10
+#define TRANSPARENT_CLOSED_IDLE             100
+
 /* List of active commands */
 #define CMD_IDLE                            ((uint16_t)0x0000)
 #define CMD_GEN_SMSNOTIFY                   ((uint16_t)0x0001)
@@ -97,10 +113,22 @@ typedef struct {
 #define CMD_SMS_DELETE                      ((uint16_t)0x0203)
 #define CMD_SMS_MASSDELETE                  ((uint16_t)0x0204)
 #define CMD_SMS_LIST                        ((uint16_t)0x0205)
+#define CMD_SMS_QUEUE                       ((uint16_t)0x0206)
+#define CMD_SMS_SEND_PDU                    ((uint16_t)0x0207)
+#define CMD_SMS_READ_PDU                    ((uint16_t)0x0208)
+#define CMD_SMS_DIRECT                      ((uint16_t)0x0209)
+#define CMD_SMS_RECONCILE                   ((uint16_t)0x020A)
+#define CMD_SMS_INDEX                       ((uint16_t)0x020B)
 #define CMD_SMS_CMGF                        ((uint16_t)0x0210)
 #define CMD_SMS_CMGS                        ((uint16_t)0x0211)
 #define CMD_SMS_CMGR                        ((uint16_t)0x0212)
 #define CMD_SMS_CMGD                        ((uint16_t)0x0213)
+#define CMD_SMS_CSMS                        ((uint16_t)0x0214)
+#define CMD_SMS_CNMI                        ((uint16_t)0x0215)
+#define CMD_SMS_CMGL                        ((uint16_t)0x0217)
+#define CMD_SMS_CPMS                        ((uint16_t)0x0218)
+#define CMD_SMS_CMGL_INDEX                  ((uint16_t)0x0219)
+#define CMD_SMS_CPMS_SET                    ((uint16_t)0x021A)
 #define CMD_IS_ACTIVE_SMS(p)                ((p)->ActiveCmd >= 0x0200 && (p)->ActiveCmd < 0x0300)
 
 #define CMD_CALL                            ((uint16_t)0x0300)
@@ -193,6 +221,28 @@ typedef struct {
 #define CMD_GPRS_FTPSSL                     ((uint16_t)0x0743)
 #define CMD_GPRS_CIPSSL                     ((uint16_t)0x0744)
 #define CMD_GPRS_CIPGSMLOC                  ((uint16_t)0x0745)
+#define CMD_GPRS_CIPQSEND                   ((uint16_t)0x0746)
+#define CMD_GPRS_CIPACK                     ((uint16_t)0x0747)
+#define CMD_GPRS_CIPSEND_GET                ((uint16_t)0x0748)
+#define CMD_GPRS_CIPMODE                    ((uint16_t)0x0749)
+#define CMD_GPRS_TRANSPARENT_EXIT           ((uint16_t)0x074A)
+#define CMD_GPRS_TRANSPARENT_RESUME         ((uint16_t)0x074B)
+#define CMD_GPRS_CIPSEND_DGRAM              ((uint16_t)0x074C)
+#define CMD_GPRS_CIPSERVER                  ((uint16_t)0x074D)
+#define CMD_GPRS_CDNSGIP                    ((uint16_t)0x074E)
+#define CMD_GPRS_CIPRXGET_LEN               ((uint16_t)0x074F)
+#define CMD_GPRS_HTTPREAD_STREAM            ((uint16_t)0x0750)
+#define CMD_GPRS_HTTPSEND_STREAM            ((uint16_t)0x0751)
+#define CMD_GPRS_HTTPUSERDATA               ((uint16_t)0x0752)
+#define CMD_GPRS_FTPDOWN_STREAM             ((uint16_t)0x0753)
+#define CMD_GPRS_FTPREST                    ((uint16_t)0x0754)
+#define CMD_GPRS_FTPSIZE                    ((uint16_t)0x0755)
+#define CMD_GPRS_FTPGETSIZE                 ((uint16_t)0x0756)
+#define CMD_GPRS_BEARER                     ((uint16_t)0x0757)
+#define CMD_GPRS_FTPUP_STREAM               ((uint16_t)0x0758)
+#define CMD_GPRS_FTPEXTGET                  ((uint16_t)0x0759)
+#define CMD_GPRS_FTPEXTGETSIZE              ((uint16_t)0x075A)
+#define CMD_GPRS_CIPHEAD                    ((uint16_t)0x075B)
 #define CMD_IS_ACTIVE_GPRS(p)               ((p)->ActiveCmd >= 0x0700 && (p)->ActiveCmd < 0x0800)
 
 #define CMD_OP_SCAN                         ((uint16_t)0x0800)
@@ -201,6 +251,12 @@ typedef struct {
 #define CMD_OP_COPS_SET                     ((uint16_t)0x0822)
 #define CMD_IS_ACTIVE_OP(p)                 ((p)->ActiveCmd >= 0x0800 && (p)->ActiveCmd < 0x0900)
 
+#define CMD_INTERNAL                        ((uint16_t)0x0900)
+#define CMD_INTERNAL_CIPCLOSE               ((uint16_t)0x0901)
+#define CMD_INTERNAL_CIPRXGET_LEN           ((uint16_t)0x0902)
+#define CMD_INTERNAL_CNMA                   ((uint16_t)0x0903)
+#define CMD_IS_ACTIVE_INTERNAL(p)           ((p)->ActiveCmd >= 0x0900 && (p)->ActiveCmd < 0x0A00)
+
 #define __DEBUG(fmt, ...)                   printf(fmt, ##__VA_ARGS__)
 
 #if GSM_RTOS
@@ -209,7 +265,14 @@ typedef struct {
 #define __IS_BUSY(p)                        ((p)->ActiveCmd != CMD_IDLE || (p)->Flags.F.Call_Idle != 0)
 #endif
 #define __IS_READY(p)                       (!__IS_BUSY(p))
-#define __CHECK_BUSY(p)                     do { if (__IS_BUSY(p)) { __RETURN(p, gsmBUSY); } } while (0)
+#if GSM_CONN_TRANSPARENT
+#define __IS_TRANSPARENT(p)                 ((p)->Flags.F.Transparent)
+#define __IS_TRANSPARENT_DATA(p)            ((p)->Flags.F.TransparentData)
+#else
+#define __IS_TRANSPARENT(p)                 0
+#define __IS_TRANSPARENT_DATA(p)            0
+#endif /* GSM_CONN_TRANSPARENT */
+#define __CHECK_BUSY(p)                     do { WaitInternal(p); if (__IS_BUSY(p) || __IS_TRANSPARENT_DATA(p)) { __RETURN(p, gsmBUSY); } } while (0)
 #define __CHECK_INPUTS(c)                   do { if (!(c)) { __RETURN(GSM, gsmPARERROR); } } while (0)
 
 #if GSM_RTOS == 1
@@ -242,17 +305,23 @@ typedef struct {
     if (!GSM_LL_Callback(GSM_LL_Control_SYS_Request, (void *)&(GSM)->Sync, &result) || result) {    \
         return gsmTIMEOUT;                      \
     }                                           \
+    (GSM)->CmdRequest = 1;                      \
+    WaitInternal(GSM);                          \
     if ((GSM)->ActiveCmd == CMD_IDLE) {         \
         (GSM)->ActiveCmdStart = (GSM)->Time;    \
     }                                           \
     (GSM)->ActiveCmd = (cmd);                   \
+    (GSM)->CmdRequest = 0;                      \
 } while (0)
 #else
 #define __ACTIVE_CMD(GSM, cmd)        do {      \
+    (GSM)->CmdRequest = 1;                      \
+    WaitInternal(GSM);                          \
     if ((GSM)->ActiveCmd == CMD_IDLE) {         \
         (GSM)->ActiveCmdStart = (GSM)->Time;    \
     }                                           \
     (GSM)->ActiveCmd = (cmd);                   \
+    (GSM)->CmdRequest = 0;                      \
 } while (0)
 #endif
 
@@ -277,6 +346,12 @@ typedef struct {
     return res;                                 \
 } while (0)
 
+#define __INTERNAL_IDLE(GSM)                do {    \
+    (GSM)->ActiveCmd = CMD_IDLE;                \
+    PT_INIT(&pt_INTERNAL);                      \
+    (GSM)->InternalActive = 0;                  \
+} while (0)
+
 #define __RST_EVENTS_RESP(p)                    do { (p)->Events.Value = 0; } while (0)
 #define __CALL_CALLBACK(p, evt)                 (p)->Callback(evt, (GSM_EventParams_t *)&(p)->CallbackParams)
     
@@ -332,7 +407,7 @@ gstatic Pointers_t Pointers;                                /* Pointers object *
 gstatic gvol GSM_t* GSM;                                    /* Working pointer to GSM_t structure */
 
 gstatic
-struct pt pt_GEN, pt_INFO, pt_PIN, pt_DATETIME, pt_GPRS, pt_OP;
+struct pt pt_GEN, pt_INFO, pt_PIN, pt_DATETIME, pt_GPRS, pt_OP, pt_INTERNAL;
 #if GSM_CALL
 gstatic struct pt pt_CALL;
 #endif /* GSM_CALL */
@@ -363,6 +438,7 @@ void __RESET_THREADS(gvol GSM_t* GSM) {
 #if GSM_PHONEBOOK
     PT_INIT(&pt_PB);
 #endif /* GSM_PHONEBOOK */
+    PT_INIT(&pt_INTERNAL);
 }
 
 /******************************************************************************/
@@ -570,20 +646,219 @@ void ParseCMGL(gvol GSM_t* GSM, GSM_SMS_Entry_t* sms, const char* str) {
     ParseCMGR(GSM, sms, str);                               /* From here, +CMGL is the same as +CMGR so use the same function as used in +CMGR response */
 }
 
+#if GSM_SMS_DIRECT
+/* Parses +CMT statement for directly delivered SMS */
+gstatic
+void ParseCMT(gvol GSM_t* GSM, GSM_SMS_Entry_t* sms, const char* str) {
+    char *p = (char *)str, *saveptr, *token;
+    uint8_t i = 0;
+    
+    memset(sms, 0x00, sizeof(GSM_SMS_Entry_t));             /* Reset entry, message is not stored in memory */
+    token = strtok_r(p, ",", &saveptr);
+    while (token != NULL) {
+        if (*token == '"') {
+            token++;
+        }
+        if (token[strlen(token) - 1] == '"') {
+            token[strlen(token) - 1] = 0;
+        }
+        switch (i) {
+            case 0:
+                strncpy(sms->Number, token, sizeof(sms->Number) - 1);
+                break;
+            case 1:
+                strncpy(sms->Name, token, sizeof(sms->Name) - 1);
+                break;
+            case 2:
+                ParseDATE(GSM, &sms->DateTime.Date, token);
+                break;
+            case 3:
+                ParseTIME(GSM, &sms->DateTime.Time, token);
+                break;
+        }
+        i++;
+        token = strtok_r(NULL, ",", &saveptr);
+    }
+}
+#endif /* GSM_SMS_DIRECT */
+
+/* Parses quoted SMS memory name of any length and moves pointer after it and its comma */
+gstatic
+GSM_SMS_Memory_t ParseSMSMemory(const char** str) {
+    const char* p = *str;
+    GSM_SMS_Memory_t memory = GSM_SMS_Memory_SM;
+    
+    if (*p == '"') {
+        p++;
+    }
+    if (strncmp(p, FROMMEM("ME"), 2) == 0) {                /* Also "ME_P" */
+        memory = GSM_SMS_Memory_ME;
+    } else if (strncmp(p, FROMMEM("MT"), 2) == 0) {
+        memory = GSM_SMS_Memory_MT;
+    } else if (strncmp(p, FROMMEM("BM"), 2) == 0) {
+        memory = GSM_SMS_Memory_BM;
+    } else if (strncmp(p, FROMMEM("SE"), 2) == 0) {
+        memory = GSM_SMS_Memory_SE;
+    }
+    while (*p && *p != '"' && *p != ',') {                  /* Skip complete name */
+        p++;
+    }
+    if (*p == '"') {
+        p++;
+    }
+    if (*p == ',') {
+        p++;
+    }
+    *str = p;
+    return memory;
+}
+
 /* Parses +CMTI statement */
 gstatic
 void ParseCMTI(gvol GSM_t* GSM, gvol GSM_SmsInfo_t* SmsInfo, const char* str) {
+    SmsInfo->Memory = ParseSMSMemory(&str);                 /* Get memory where message is stored */
+    SmsInfo->Position = ParseNumber(str, NULL);
+}
+
+#if GSM_SMS_INDEX
+#define SMS_INDEX_FREE                      0x00            /* Position is empty */
+#define SMS_INDEX_UNREAD                    0x01            /* Received message, not read yet */
+#define SMS_INDEX_READ                      0x02            /* Received message, already read */
+#define SMS_INDEX_UNSENT                    0x03            /* Stored message, not sent yet */
+#define SMS_INDEX_SENT                      0x04            /* Stored message, already sent */
+
+/* Parses message status from +CMGR or +CMGL response, in text or PDU mode */
+gstatic
+uint8_t ParseSMSStatus(const char* str) {
     if (*str == '"') {
         str++;
     }
-    if (strncmp(str, "ME", 2) == 0) {
-        SmsInfo->Memory = GSM_SMS_Memory_ME;
-    } else if (strncmp(str, "SM", 2) == 0) {
-        SmsInfo->Memory = GSM_SMS_Memory_SM;
+    if (strncmp(str, FROMMEM("REC UNREAD"), 10) == 0 || *str == '0') {
+        return SMS_INDEX_UNREAD;
+    } else if (strncmp(str, FROMMEM("STO UNSENT"), 10) == 0 || *str == '2') {
+        return SMS_INDEX_UNSENT;
+    } else if (strncmp(str, FROMMEM("STO SENT"), 8) == 0 || *str == '3') {
+        return SMS_INDEX_SENT;
     }
-    str += 4;
-    SmsInfo->Position = ParseNumber(str, NULL);
+    return SMS_INDEX_READ;
+}
+
+/* Parses +CPMS response with size of storage, last memory is used for received messages */
+gstatic
+void ParseCPMS(gvol GSM_t* GSM, const char* str) {
+    uint8_t cnt, i;
+    
+    for (i = 0; i < 3 && *str && *str != '\r'; i++) {       /* Go through all memories, up to 3 */
+        GSM->SmsIndex.Memory = ParseSMSMemory(&str);        /* Memory name */
+        ParseNumber(str, &cnt);                             /* Skip number of used positions */
+        str += cnt + 1;
+        GSM->SmsIndex.Total = ParseNumber(str, &cnt);       /* Get number of all positions */
+        str += cnt;
+        if (*str == ',') {
+            str++;
+        }
+    }
+}
+
+/* Sets status of position in storage index */
+gstatic
+void IndexSet(gvol GSM_t* GSM, uint16_t position, uint8_t status) {
+    if (position < 1 || position > GSM_SMS_INDEX_SIZE) {    /* Position is not indexed */
+        GSM->SmsIndex.Valid = 0;                            /* Index must be built again */
+        return;
+    }
+    GSM->SmsIndex.Status[position - 1] = status;
+}
+
+/* Updates index after message was read, module marks unread message as read */
+gstatic
+void IndexRead(gvol GSM_t* GSM, uint16_t position, const char* str) {
+    uint8_t status = ParseSMSStatus(str);
+    
+    IndexSet(GSM, position, status == SMS_INDEX_UNREAD ? SMS_INDEX_READ : status);
+}
+
+/* Updates index from +CMGL response, messages are listed without status change */
+gstatic
+void IndexList(gvol GSM_t* GSM, const char* str) {
+    uint8_t cnt;
+    uint16_t pos = ParseNumber(str, &cnt);
+    
+    IndexSet(GSM, pos, ParseSMSStatus(str + cnt + 1));
+}
+
+/* Frees positions removed with mass delete */
+gstatic
+void IndexMassDelete(gvol GSM_t* GSM, GSM_SMS_MassDelete_t type) {
+    uint16_t i;
+    uint8_t s;
+    
+    for (i = 0; i < GSM_SMS_INDEX_SIZE; i++) {
+        s = GSM->SmsIndex.Status[i];
+        if (type == GSM_SMS_MassDelete_All ||
+            (type == GSM_SMS_MassDelete_Read && s == SMS_INDEX_READ) ||
+            (type == GSM_SMS_MassDelete_Unread && s == SMS_INDEX_UNREAD) ||
+            (type == GSM_SMS_MassDelete_Sent && s == SMS_INDEX_SENT) ||
+            (type == GSM_SMS_MassDelete_Unsent && s == SMS_INDEX_UNSENT) ||
+            (type == GSM_SMS_MassDelete_Inbox && (s == SMS_INDEX_READ || s == SMS_INDEX_UNREAD))) {
+            GSM->SmsIndex.Status[i] = SMS_INDEX_FREE;
+        }
+    }
+}
+#endif /* GSM_SMS_INDEX */
+
+/* Gets string for SMS list type */
+gstatic
+const char* SMSReadTypeString(GSM_SMS_ReadType_t type) {
+    switch (type) {                                         /* Check for proper type */
+        case GSM_SMS_ReadType_READ:     return FROMMEM("REC READ");
+        case GSM_SMS_ReadType_UNREAD:   return FROMMEM("REC UNREAD");
+        case GSM_SMS_ReadType_SENT:     return FROMMEM("STO SENT");
+        case GSM_SMS_ReadType_UNSENT:   return FROMMEM("STO UNSENT");
+        case GSM_SMS_ReadType_ALL:
+        default: 
+            return FROMMEM("ALL");
+    }
+}
+
+#if GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX
+/* Gets string for SMS memory */
+gstatic
+const char* SMSMemoryString(GSM_SMS_Memory_t memory) {
+    switch (memory) {                                       /* Check for proper memory */
+        case GSM_SMS_Memory_BM:         return FROMMEM("BM");
+        case GSM_SMS_Memory_SE:         return FROMMEM("SE");
+        case GSM_SMS_Memory_ME:         return FROMMEM("ME");
+        case GSM_SMS_Memory_MT:         return FROMMEM("MT");
+        case GSM_SMS_Memory_SM:
+        default:
+            return FROMMEM("SM");
+    }
+}
+#endif /* GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX */
+
+#if GSM_SMS_CMTI_QUEUE
+/* Adds received SMS notification to queue, positions already in queue are ignored */
+gstatic
+void ArrivalAdd(gvol GSM_t* GSM, GSM_SMS_Memory_t memory, uint16_t position) {
+    gvol GSM_SMS_Arrivals_t* q = &GSM->SmsArrivals;
+    uint32_t i;
+    
+    for (i = q->Out; i != q->In; i++) {                     /* Check for duplicates */
+        if (q->Entries[i % GSM_SMS_CMTI_QUEUE].Position == position && q->Entries[i % GSM_SMS_CMTI_QUEUE].Memory == memory) {
+            return;
+        }
+    }
+    if (q->In - q->Out >= GSM_SMS_CMTI_QUEUE) {             /* Queue is full */
+        q->Overflow++;
+        q->Reconcile = 1;                                   /* User must list unread messages when queue is empty */
+        return;
+    }
+    q->Entries[q->In % GSM_SMS_CMTI_QUEUE].Memory = memory;
+    q->Entries[q->In % GSM_SMS_CMTI_QUEUE].Position = position;
+    q->In++;
 }
+#endif /* GSM_SMS_CMTI_QUEUE */
 #endif /* GSM_SMS */
 
 /* Parses +CPIN statement */
@@ -686,22 +961,188 @@ void ParseCIPRXGET(gvol GSM_t* GSM, GSM_CONN_t* conn, const char* str) {
     num = ParseNumber(str, &cnt);                           /* Response number */
     str += cnt + 1;
     connID = ParseNumber(str, &cnt);                        /* Connection ID */
+    if (conn == NULL && connID < 6) {
+        conn = GSM->Conns[connID];                          /* Get connection pointer */
+    }
+    if (conn == NULL) {
+        return;
+    }
     if (num == 1) {                                         /* Notification about new data received */
-        if (conn == NULL) {
-            conn = GSM->Conns[connID];                      /* Get connection pointer */
-        }
-        if (conn != NULL) {
-            conn->Flags.F.RxGetReceived = 1;                /* We have new incoming data available in buffer to read for specific connection */
-            conn->Flags.F.CallGetReceived = 1;              /* Notify user with callback */
-        }
+        conn->Flags.F.RxGetReceived = 1;                    /* We have new incoming data available in buffer to read for specific connection */
+        conn->Flags.F.CallGetReceived = 1;                  /* Notify user with callback */
+        conn->Flags.F.RxLengthKnown = 0;                    /* Number of waiting bytes is not known */
+#if GSM_CONN_RX_LENGTH
+        GSM->ConnRxLength |= 1 << connID;                   /* Read number of waiting bytes when stack is idle */
+#endif /* GSM_CONN_RX_LENGTH */
     }
     str += cnt + 1;
-    if (num == 2 && conn != NULL) {
+    if (num == 2) {
         conn->BytesReadRemaining = ParseNumber(str, &cnt);  /* Bytes returned from response */
         str += cnt + 1;
         conn->BytesRemaining = ParseNumber(str, NULL);      /* Bytes remaining in buffer */
+        conn->Flags.F.RxLengthKnown = 1;
+    }
+    if (num == 4) {
+        conn->BytesReadRemaining = 0;                       /* No data follow response */
+        conn->BytesRemaining = ParseNumber(str, NULL);      /* Bytes waiting in buffer */
+        conn->Flags.F.RxLengthKnown = 1;
+    }
+#if GSM_CONN_RX_LENGTH
+    if (conn->Flags.F.RxLengthKnown) {
+        GSM->ConnRxLength &= ~(1 << conn->ID);              /* Number of waiting bytes is known now */
+    }
+#endif /* GSM_CONN_RX_LENGTH */
+}
+
+#if GSM_CONN_RX_DGRAM
+/* Parses +RECEIVE statement and prepares receive buffer for packet data */
+gstatic
+void ParseRECEIVE(gvol GSM_t* GSM, const char* str) {
+    uint8_t cnt, connID;
+    uint16_t len;
+    GSM_CONN_t* conn = NULL;
+    
+    connID = ParseNumber(str, &cnt);                        /* Connection ID */
+    str += cnt + 1;
+    len = ParseNumber(str, NULL);                           /* Number of bytes following statement */
+    if (connID < 6) {
+        conn = GSM->Conns[connID];                          /* Get connection pointer */
+    }
+    GSM->ConnRxConn = NULL;
+    GSM->ConnRxRemaining = len;
+    if (conn != NULL && conn->RxBuff != NULL && len && conn->RxSize - (conn->RxIn - conn->RxOut) >= (uint32_t)len + 2) {
+        conn->RxBuff[conn->RxIn % conn->RxSize] = len & 0xFF;   /* Save packet length in front of data */
+        conn->RxBuff[(conn->RxIn + 1) % conn->RxSize] = len >> 8;
+        GSM->ConnRxConn = conn;
+        GSM->ConnRxPos = conn->RxIn + 2;
+    } else if (conn != NULL) {
+        conn->RxDropped++;                                  /* Packet does not fit to buffer */
+    }
+    GSM->Flags.F.CLIENT_Recv_Data = len > 0;                /* Raw data follow */
+}
+
+/* Reads data from connection receive buffer as byte stream */
+gstatic
+uint16_t ConnRxRead(gvol GSM_CONN_t* conn, uint8_t* data, uint16_t btr) {
+    uint16_t len, i, br = 0;
+    
+    while (br < btr && conn->RxIn != conn->RxOut) {
+        len = conn->RxBuff[conn->RxOut % conn->RxSize] | (conn->RxBuff[(conn->RxOut + 1) % conn->RxSize] << 8);
+        for (i = 0; i < len && br < btr; i++) {
+            data[br++] = conn->RxBuff[(conn->RxOut + 2 + i) % conn->RxSize];
+        }
+        if (i == len) {                                     /* Complete packet was read */
+            conn->RxOut += 2 + len;
+        } else {                                            /* Move length header in front of remaining data */
+            conn->RxBuff[(conn->RxOut + i) % conn->RxSize] = (len - i) & 0xFF;
+            conn->RxBuff[(conn->RxOut + i + 1) % conn->RxSize] = (len - i) >> 8;
+            conn->RxOut += i;
+        }
+    }
+    conn->Flags.F.RxGetReceived = conn->RxIn != conn->RxOut;    /* Data still waiting? */
+    return br;
+}
+#endif /* GSM_CONN_RX_DGRAM */
+
+/* Parses +CIPSEND? statement */
+gstatic
+void ParseCIPSEND(gvol GSM_t* GSM, const char* str) {
+    uint8_t cnt;
+    uint16_t size;
+    
+    ParseNumber(str, &cnt);                                 /* Ignore connection number */
+    str += cnt + 1;
+    size = ParseNumber(str, NULL);                          /* Maximal data length for connection */
+    if (size >= CONN_SEGMENT_SIZE_MIN) {                    /* Ignore invalid values */
+        GSM->ConnMaxSegmentSize = size;
+    }
+}
+
+#if GSM_CONN_QSEND
+/* Parses +CIPACK statement */
+gstatic
+void ParseCIPACK(gvol GSM_t* GSM, GSM_CONN_t* conn, const char* str) {
+    uint8_t cnt;
+    
+    ParseNumber(str, &cnt);                                 /* Ignore number of bytes sent by module */
+    str += cnt + 1;
+    if (conn != NULL) {
+        conn->BytesAcked = ParseNumber(str, &cnt);          /* Number of bytes acknowledged by remote side */
+    }
+}
+#endif /* GSM_CONN_QSEND */
+
+#if GSM_CONN_DNS_CACHE
+/* Parses +CDNSGIP statement */
+gstatic
+void ParseCDNSGIP(gvol GSM_t* GSM, const char* str) {
+    uint8_t i = 0;
+    
+    if (*str == '1' && (str = strstr(str, FROMMEM("\",\""))) != NULL) {   /* Skip host name */
+        str += 3;
+        while (*str && *str != '"' && i < sizeof(GSM->DNSAddr) - 1) {
+            GSM->DNSAddr[i++] = *str++;                     /* Copy first address */
+        }
+        GSM->DNSAddr[i] = 0;
+        GSM->Events.F.RespDNSOk = 1;                        /* Host was resolved */
+    } else {
+        GSM->Events.F.RespDNSFail = 1;                      /* DNS error */
+    }
+}
+
+/* Checks if host is already IP address */
+gstatic
+uint8_t IsIPAddress(const char* host) {
+    while (*host) {
+        if (!CHARISNUM(*host) && *host != '.') {
+            return 0;
+        }
+        host++;
+    }
+    return 1;
+}
+
+/* Finds valid entry in DNS cache for host */
+gstatic
+GSM_CONN_DNSEntry_t* DNSCacheFind(gvol GSM_t* GSM, const char* host) {
+    uint8_t i;
+    
+    for (i = 0; i < GSM_CONN_DNS_CACHE; i++) {
+        GSM_CONN_DNSEntry_t* e = (GSM_CONN_DNSEntry_t *)&GSM->DNSCache[i];
+        if (e->Host[0] && strcmp(e->Host, host) == 0) {
+            if ((GSM->Time - e->Time) < GSM_CONN_DNS_CACHE_TTL) {
+                return e;
+            }
+            e->Host[0] = 0;                                 /* Entry has expired */
+        }
+    }
+    return NULL;
+}
+
+/* Saves resolved address to DNS cache */
+gstatic
+void DNSCacheInsert(gvol GSM_t* GSM, const char* host, const char* addr) {
+    GSM_CONN_DNSEntry_t* entry = NULL;
+    uint8_t i;
+    
+    if (strlen(host) >= GSM_CONN_DNS_CACHE_HOST_LENGTH) {   /* Host name is too long to be cached */
+        return;
+    }
+    for (i = 0; i < GSM_CONN_DNS_CACHE; i++) {              /* Find free or oldest entry */
+        GSM_CONN_DNSEntry_t* e = (GSM_CONN_DNSEntry_t *)&GSM->DNSCache[i];
+        if (!e->Host[0] || strcmp(e->Host, host) == 0) {
+            entry = e;
+            break;
+        }
+        if (entry == NULL || (GSM->Time - e->Time) > (GSM->Time - entry->Time)) {
+            entry = e;
+        }
     }
+    strcpy(entry->Host, host);
+    strcpy(entry->Addr, addr);
+    entry->Time = GSM->Time;
 }
+#endif /* GSM_CONN_DNS_CACHE */
 
 #if GSM_HTTP
 /* Parse +HTTPACTION statement */
@@ -763,6 +1204,36 @@ void ParseFTPGET(gvol GSM_t* GSM, gvol GSM_FTP_t* ftp, const char* str) {
         }
     }
 }
+
+/* Parse +FTPSIZE statement */
+gstatic
+void ParseFTPSIZE(gvol GSM_t* GSM, gvol GSM_FTP_t* ftp, const char* str) {
+    uint8_t cnt;
+    
+    ftp->Mode = ParseNumber(str, &cnt);                     /* Parse number for method */
+    str += cnt + 1;
+    ftp->ErrorCode = ParseNumber(str, &cnt);                /* Get error code */
+    str += cnt + 1;
+    ftp->FileSize = ParseNumber(str, &cnt);                 /* Get file size */
+}
+
+/* Parse +FTPEXTGET statement */
+gstatic
+void ParseFTPEXTGET(gvol GSM_t* GSM, gvol GSM_FTP_t* ftp, const char* str) {
+    uint8_t cnt;
+    uint32_t num;
+    
+    ftp->Mode = ParseNumber(str, &cnt);                     /* Parse number for method */
+    str += cnt + 1;
+    num = ParseNumber(str, &cnt);
+    if (ftp->Mode == 3) {                                   /* Reading data from module memory */
+        ftp->BytesReadRemaining = num;                      /* Number of bytes to read in this call */
+    } else if (GSM->ActiveCmd == CMD_GPRS_FTPEXTGETSIZE) {  /* Response to size query */
+        ftp->FileSize = num;
+    } else {
+        ftp->ErrorCode = num;                               /* Download status */
+    }
+}
 #endif /* GSM_FTP */
 
 /* Parse +CIPGSMLOC statement */
@@ -1026,7 +1497,7 @@ void ParseReceived(gvol GSM_t* GSM, Received_t* Received) {
         } else if (strcmp(&str[1], FROMMEM(", ALREADY CONNECT\r\n")) == 0) {    /* n, ALREADY CONNECT received */
             GSM->Events.F.RespConnectAlready = 1;
         }
-    } else if (GSM->ActiveCmd == CMD_GPRS_CIPCLOSE) {
+    } else if (GSM->ActiveCmd == CMD_GPRS_CIPCLOSE || GSM->ActiveCmd == CMD_INTERNAL_CIPCLOSE) {
         if (strcmp(&str[1], FROMMEM(", CLOSE OK\r\n")) == 0) {  /* n, CLOSE OK received */
             GSM->Events.F.RespCloseOk = 1;                  /* Closed OK */
             is_ok = 1;                                      /* Response is OK */
@@ -1039,6 +1510,80 @@ void ParseReceived(gvol GSM_t* GSM, Received_t* Received) {
             GSM->Events.F.RespSendFail = 1;
             is_error = 1;
         }
+#if GSM_CONN_QSEND
+        else if (strncmp(str, FROMMEM("DATA ACCEPT:"), 12) == 0) {  /* DATA ACCEPT:n,len received in quick send mode */
+            GSM_CONN_t* conn = (GSM_CONN_t *)Pointers.Ptr1;
+            uint8_t cnt;
+            
+            ParseNumber(&str[12], &cnt);                    /* Ignore connection number */
+            if (conn != NULL) {
+                conn->BytesAccepted += ParseNumber(&str[12 + cnt + 1], NULL);   /* Increase number of accepted bytes */
+            }
+            GSM->Events.F.RespDataAccept = 1;
+            is_ok = 1;
+        }
+#endif /* GSM_CONN_QSEND */
+    }
+#if GSM_CONN_TRANSPARENT
+    if (GSM->Flags.F.Transparent) {                         /* Single connection responses */
+        if ((GSM->ActiveCmd == CMD_GPRS_CIPSTART || GSM->ActiveCmd == CMD_GPRS_TRANSPARENT_RESUME) && 
+                strcmp(str, FROMMEM("CONNECT\r\n")) == 0) {   /* CONNECT received, data mode starts now */
+            GSM->Events.F.RespConnectOk = 1;
+            GSM->Flags.F.TransparentData = 1;               /* Stop parsing, everything from now on is raw data */
+            GSM->TransparentClosed = 0;
+            GSM->TransparentScanned = Buffer.Out;           /* Check data from here for remote close notification */
+            GSM->TransparentMatch = 0;
+            GSM->TransparentRxTime = GSM->Time;
+            is_ok = 1;
+        } else if (GSM->ActiveCmd == CMD_GPRS_CIPSTART && strcmp(str, FROMMEM("CONNECT FAIL\r\n")) == 0) {
+            GSM->Events.F.RespConnectFail = 1;
+        } else if (GSM->ActiveCmd == CMD_GPRS_CIPSTART && strcmp(str, FROMMEM("ALREADY CONNECT\r\n")) == 0) {
+            GSM->Events.F.RespConnectAlready = 1;
+        } else if (GSM->ActiveCmd == CMD_GPRS_CIPCLOSE && strcmp(str, FROMMEM("CLOSE OK\r\n")) == 0) {
+            GSM->Events.F.RespCloseOk = 1;                  /* Closed OK */
+            is_ok = 1;
+        } else if (GSM->ActiveCmd == CMD_GPRS_TRANSPARENT_RESUME && strcmp(str, GSM_NO_CARRIER) == 0) {
+            is_error = 1;                                   /* Connection is not active anymore */
+        } else if (strcmp(str, FROMMEM("CLOSED\r\n")) == 0 && GSM->Conns[0]) {   /* Connection closed by remote side */
+            GSM->Conns[0]->Flags.F.Active = 0;
+            GSM->Conns[0]->Flags.F.CallConnClosed = 1;
+        }
+    }
+#endif /* GSM_CONN_TRANSPARENT */
+    
+    if (GSM->ActiveCmd == CMD_GPRS_CIPSERVER && strcmp(str, FROMMEM("SERVER OK\r\n")) == 0) {
+        GSM->Events.F.RespServerOk = 1;                     /* Server is listening */
+    }
+    
+    /* New connection accepted by server */
+    if (GSM->ServerConns != NULL && CHARISNUM(*str) && strncmp(&str[1], FROMMEM(", REMOTE IP:"), 12) == 0) {
+        uint8_t num = CHARTONUM(str[0]), i;                 /* Get connection number */
+        for (i = 0; i < GSM->ServerConnsCount; i++) {
+            GSM_CONN_t* conn = &GSM->ServerConns[i];
+            if (!conn->Flags.F.Active) {                    /* Find free connection structure */
+#if GSM_CONN_RX_DGRAM
+                uint8_t* rxbuff = conn->RxBuff;             /* Receive buffer is set by user */
+                uint16_t rxsize = conn->RxSize;
+#endif /* GSM_CONN_RX_DGRAM */
+                memset((void *)conn, 0x00, sizeof(GSM_CONN_t));
+#if GSM_CONN_RX_DGRAM
+                conn->RxBuff = rxbuff;
+                conn->RxSize = rxsize;
+#endif /* GSM_CONN_RX_DGRAM */
+                conn->ID = num;                             /* Set connection ID */
+                conn->SegmentSize = GSM->ConnMaxSegmentSize;/* Use maximal segment size */
+                conn->SegmentLimit = GSM->ConnMaxSegmentSize;
+                conn->Flags.F.Active = 1;                   /* Connection is active */
+                conn->Flags.F.Opened = 1;
+                conn->Flags.F.CallAccepted = 1;             /* Notify user about new connection */
+                GSM->Conns[num] = conn;                     /* Save connection pointer */
+                break;
+            }
+        }
+        if (i == GSM->ServerConnsCount) {                   /* No free connection structure */
+            GSM->Conns[num] = NULL;                         /* Do not use old connection on this ID */
+            GSM->ConnReject |= 1 << num;                    /* Close connection when stack is idle */
+        }
     }
     
     /* Connection closed by remote device */
@@ -1066,15 +1611,104 @@ void ParseReceived(gvol GSM_t* GSM, Received_t* Received) {
         if (GSM->ActiveCmd == CMD_GPRS_CREG && strncmp(str, FROMMEM("+CREG:"), 6) == 0) {
             ParseCREG(GSM, &str[7]);                        /* Parse CREG response */
         }
+#if GSM_SMS && GSM_SMS_DIRECT
+        else if (strncmp(str, FROMMEM("+CMT:"), 5) == 0) {  /* Directly delivered SMS, data follow in next line */
+            gvol GSM_SMS_Direct_t* direct = GSM->SmsDirect;
+            const char* tmp = str + 6;
+            uint8_t commas = 0;
+            while (*tmp) {                                  /* Text mode header has number, name, date and time */
+                if (*tmp++ == ',') {
+                    commas++;
+                }
+            }
+            if (str[6] != '"' || commas < 2) {              /* PDU mode header (<alpha>,<length>), not supported */
+                GSM->Flags.F.SMS_CMT_Drop = 1;
+            } else if (direct != NULL && direct->In - direct->Out < direct->Size) {  /* Check for free entry */
+                ParseCMT(GSM, &direct->Entries[direct->In % direct->Size], str + 6); /* Parse header to next entry */
+                GSM->Flags.F.SMS_CMT_Drop = 0;
+            } else {
+                GSM->Flags.F.SMS_CMT_Drop = 1;              /* Ignore data, no memory */
+            }
+            GSM->Flags.F.SMS_CMT_Read_Data = 1;             /* Next step is to read actual SMS data */
+        }
+#endif /* GSM_SMS && GSM_SMS_DIRECT */
 #if GSM_SMS
+        else if (strncmp(str, FROMMEM("+CMTI:"), 6) == 0) { /* Parse before SMS commands, notification may arrive at any time */
+            uint8_t i = 0;
+#if GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX
+            GSM_SmsInfo_t info;
+            
+            ParseCMTI(GSM, &info, str + 7);                 /* Parse +CMTI statement */
+#endif /* GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX */
+#if GSM_SMS_CMTI_QUEUE
+            GSM->SmsArrivals.Memory = info.Memory;          /* Save memory for lost notifications */
+            ArrivalAdd(GSM, info.Memory, info.Position);    /* Add notification to queue */
+#endif /* GSM_SMS_CMTI_QUEUE */
+#if GSM_SMS_INDEX
+            if (info.Memory == GSM->SmsIndex.Memory) {      /* New message in indexed storage */
+                IndexSet(GSM, info.Position, SMS_INDEX_UNREAD);
+            }
+#endif /* GSM_SMS_INDEX */
+            for (i = 0; i < GSM_MAX_RECEIVED_SMS_INFO; i++) {
+                if (!GSM->SmsInfos[i].Flags.F.Used && !GSM->SmsInfos[i].Flags.F.Received) { /* Check if available memory */
+                    GSM->SmsInfos[i].Flags.F.Used = 1;      /* We have used this memory */
+                    GSM->SmsInfos[i].Flags.F.Received = 1;  /* We have received memory */
+                    
+                    ParseCMTI(GSM, (GSM_SmsInfo_t *)&GSM->SmsInfos[i], str + 7); /* Parse +CMTI statement */
+                    break;
+                }
+            }
+            GSM->Flags.F.SMS_CMTI_Received = 1;             /* Set flag for callback */
+        }
         else if (CMD_IS_ACTIVE_SMS(GSM)) {                /* Currently active command is regarding SMS */
             if (GSM->ActiveCmd == CMD_SMS_SEND && strncmp(str, FROMMEM("+CMGS:"), 6) == 0) {  /* We just sent SMS and number in memory is returned */
                 GSM->SMS.SentSMSMemNum = ParseNumber(&str[7], NULL);/* Parse number and save it */
             } else if (GSM->ActiveCmd == CMD_SMS_READ && strncmp(str, FROMMEM("+CMGR:"), 6) == 0) { /* When SMS Read instruction is executed */
+#if GSM_SMS_INDEX
+                IndexRead(GSM, ((GSM_SMS_Entry_t *)Pointers.Ptr1)->Position, str + 7);
+#endif /* GSM_SMS_INDEX */
                 ParseCMGR(GSM, (GSM_SMS_Entry_t *)Pointers.Ptr1, str + 7);  /* Parse received command for read SMS */
                 GSM->Flags.F.SMS_Read_Data = 1;             /* Next step is to read actual SMS data */
                 ((GSM_SMS_Entry_t *)Pointers.Ptr1)->DataLen = 0; /* Reset data length */
+#if GSM_SMS_INDEX
+            } else if (GSM->ActiveCmd == CMD_SMS_CPMS && strncmp(str, FROMMEM("+CPMS:"), 6) == 0) {  /* Storage size for index */
+                ParseCPMS(GSM, str + 7);
+            } else if (GSM->ActiveCmd == CMD_SMS_CMGL_INDEX && strncmp(str, FROMMEM("+CMGL:"), 6) == 0) {   /* Message listed to build index */
+                IndexList(GSM, str + 7);
+                GSM->Flags.F.SMS_Read_Data = 1;             /* Ignore SMS data in next line */
+#endif /* GSM_SMS_INDEX */
+#if GSM_SMS_CMTI_QUEUE
+            } else if (GSM->ActiveCmd == CMD_SMS_CMGL && strncmp(str, FROMMEM("+CMGL:"), 6) == 0) { /* Unread message found on reconciliation */
+                ArrivalAdd(GSM, GSM->SmsArrivals.Memory, ParseNumber(str + 7, NULL));
+#if GSM_SMS_INDEX
+                if (GSM->SmsArrivals.Memory == GSM->SmsIndex.Memory) {
+                    IndexList(GSM, str + 7);
+                }
+#endif /* GSM_SMS_INDEX */
+                GSM->Flags.F.SMS_Read_Data = 1;             /* Ignore SMS data in next line */
+                GSM->Flags.F.SMS_CMTI_Received = 1;         /* Set flag for callback */
+#endif /* GSM_SMS_CMTI_QUEUE */
+#if GSM_SMS_PDU
+            } else if (GSM->ActiveCmd == CMD_SMS_CMGR && strncmp(str, FROMMEM("+CMGR:"), 6) == 0) { /* SMS read in PDU mode */
+#if GSM_SMS_INDEX
+                IndexRead(GSM, GSM->SMS.Position, str + 7);
+#endif /* GSM_SMS_INDEX */
+                GSM->Flags.F.SMS_Read_Data = 1;             /* Next line is PDU */
+                GSM->SMS.ReadLen = 0;                       /* Reset PDU length */
+#endif /* GSM_SMS_PDU */
+            } else if (GSM->ActiveCmd == CMD_SMS_LIST && GSM->SmsListCallback != NULL && strncmp(str, FROMMEM("+CMGL:"), 6) == 0) {  /* When streaming list command is executed */
+#if GSM_SMS_INDEX
+                IndexList(GSM, str + 7);
+#endif /* GSM_SMS_INDEX */
+                if (!GSM->SmsListStop) {                    /* Does user still want messages? */
+                    ParseCMGL(GSM, (GSM_SMS_Entry_t *)Pointers.Ptr1, str + 7);
+                    ((GSM_SMS_Entry_t *)Pointers.Ptr1)->DataLen = 0; /* Reset data length */
+                }
+                GSM->Flags.F.SMS_Read_Data = 1;             /* Next step is to read actual SMS data */
             } else if (GSM->ActiveCmd == CMD_SMS_LIST && strncmp(str, FROMMEM("+CMGL:"), 6) == 0) {  /* When list command is executed */
+#if GSM_SMS_INDEX
+                IndexList(GSM, str + 7);
+#endif /* GSM_SMS_INDEX */
                 if (*(uint16_t *)Pointers.Ptr2 < Pointers.UI) { /* Do we still have empty memory to read data? */
                     ParseCMGL(GSM, (GSM_SMS_Entry_t *)Pointers.Ptr1, str + 7);
                     ((GSM_SMS_Entry_t *)Pointers.Ptr1)->DataLen = 0; /* Reset data length */
@@ -1118,27 +1752,17 @@ void ParseReceived(gvol GSM_t* GSM, Received_t* Received) {
             GSM->Flags.F.CALL_CLCC_Received = 1;            /* Set flag for callback */
         }
 #endif
-#if GSM_SMS
-        else if (strncmp(str, FROMMEM("+CMTI:"), 6) == 0) {
-            uint8_t i = 0;
-            for (i = 0; i < GSM_MAX_RECEIVED_SMS_INFO; i++) {
-                if (!GSM->SmsInfos[i].Flags.F.Used && !GSM->SmsInfos[i].Flags.F.Received) { /* Check if available memory */
-                    GSM->SmsInfos[i].Flags.F.Used = 1;      /* We have used this memory */
-                    GSM->SmsInfos[i].Flags.F.Received = 1;  /* We have received memory */
-                    
-                    ParseCMTI(GSM, (GSM_SmsInfo_t *)&GSM->SmsInfos[i], str + 7); /* Parse +CMTI statement */
-                    break;
-                }
-            }
-            GSM->Flags.F.SMS_CMTI_Received = 1;             /* Set flag for callback */
-        } 
-#endif /* GSM_SMS */
+#if GSM_CONN_RX_DGRAM
+        else if (strncmp(str, FROMMEM("+RECEIVE,"), 9) == 0) {  /* Data pushed by module in automatic receive mode */
+            ParseRECEIVE(GSM, str + 9);
+        }
+#endif /* GSM_CONN_RX_DGRAM */
         else if (strncmp(str, FROMMEM("+CIPRXGET:"), 10) == 0) {/* +CIPRXGET statement */
             if (strlen(&str[11]) > 5) {                     /* We executed command */
-                GSM_CONN_t* conn = (GSM_CONN_t *)Pointers.Ptr1;
+                GSM_CONN_t* conn = CMD_IS_ACTIVE_INTERNAL(GSM) ? NULL : (GSM_CONN_t *)Pointers.Ptr1;
                 ParseCIPRXGET(GSM, conn, str + 11);         /* Parse statement */
                 GSM->Flags.F.CLIENT_Read_Data = 0;          /* Reset flag to read data first */
-                if (conn->BytesReadRemaining) {             /* Any bytes to read? */
+                if (conn != NULL && conn->BytesReadRemaining) { /* Any bytes to read? */
                     GSM->Flags.F.CLIENT_Read_Data = 1;      /* Read raw data from response */
                 }
             } else {                                        /* Notification info */
@@ -1170,7 +1794,30 @@ void ParseReceived(gvol GSM_t* GSM, Received_t* Received) {
             if (GSM->FTP.Mode == 2) {                       /* +FTPPUT:2,.. received */
                 GSM->Events.F.RespFtpUploadReady = 1;       /* Upload is ready to proceed */
             }
+        } else if (strncmp(str, FROMMEM("+FTPEXTGET:"), 11) == 0) {    /* Parse FTPEXTGET */
+            ParseFTPEXTGET(GSM, (GSM_FTP_t *)&GSM->FTP, &str[12]);  /* Parse FTPEXTGET statement */
+            GSM->Events.F.RespFtpExtGet = 1;                /* FTP EXTGET was received */
+            
+            if (GSM->FTP.Mode == 3) {                       /* Read procedure */
+                GSM->FTP.BytesRead = 0;                     /* Reset number of read bytes */
+                if (GSM->FTP.BytesReadRemaining > 0) {      /* Check if we should read anything */
+                    GSM->Flags.F.FTP_Read_Data = 1;         /* Activate flag to read data */
+                }
+            }
+        } else if (strncmp(str, FROMMEM("+FTPSIZE:"), 9) == 0) {    /* Parse FTPSIZE */
+            ParseFTPSIZE(GSM, (GSM_FTP_t *)&GSM->FTP, &str[10]);    /* Parse FTPSIZE statement */
+            GSM->Events.F.RespFtpSize = 1;                  /* FTP SIZE was received */
 #endif /* GSM_FTP */
+#if GSM_CONN_QSEND
+        } else if (GSM->ActiveCmd == CMD_GPRS_CIPACK && strncmp(str, FROMMEM("+CIPACK:"), 8) == 0) {
+            ParseCIPACK(GSM, (GSM_CONN_t *)Pointers.Ptr1, str[8] == ' ' ? str + 9 : str + 8);  /* Parse acknowledge status */
+#endif /* GSM_CONN_QSEND */
+#if GSM_CONN_DNS_CACHE
+        } else if (GSM->ActiveCmd == CMD_GPRS_CDNSGIP && strncmp(str, FROMMEM("+CDNSGIP:"), 9) == 0) {
+            ParseCDNSGIP(GSM, str[9] == ' ' ? str + 10 : str + 9);  /* Parse resolved address */
+#endif /* GSM_CONN_DNS_CACHE */
+        } else if (GSM->ActiveCmd == CMD_GPRS_CIPSEND_GET && strncmp(str, FROMMEM("+CIPSEND:"), 9) == 0) {
+            ParseCIPSEND(GSM, str[9] == ' ' ? str + 10 : str + 9);  /* Parse maximal data length */
         } else if (GSM->ActiveCmd == CMD_GPRS_CIPGSMLOC && strncmp(str, FROMMEM("+CIPGSMLOC"), 10) == 0) {
             if (Pointers.Ptr1) {                            /* Check valid pointer */
                 ParseCIPGSMLOC(GSM, (GSM_GPS_t *)Pointers.Ptr1, str + 12);  /* Parse GPS location and time */
@@ -1222,14 +1869,59 @@ GSM_Result_t StartCommand(gvol GSM_t* GSM, uint16_t cmd, const char* cmdResp) {
     return gsmOK;
 }
 
-/* Converts number to string */
+/* Starts command executed by stack on its own, result of user command is not changed */
 gstatic
-void NumberToString(char* str, uint32_t number) {
-    sprintf(str, "%u", number);
+GSM_Result_t StartInternal(gvol GSM_t* GSM, uint16_t cmd, uint32_t timeout) {
+    GSM->ActiveCmd = cmd;
+    GSM->ActiveCmdResp = NULL;
+    GSM->ActiveCmdStart = GSM->Time;
+    GSM->ActiveCmdTimeout = timeout;
+    
+    return gsmOK;
 }
 
+/* Waits for internal command to finish before user command can start */
+gstatic
+void WaitInternal(gvol GSM_t* GSM) {
+    while (GSM->InternalActive) {
+#if !GSM_RTOS && !GSM_ASYNC
+        GSM_Update(GSM);                                    /* Process incoming data */
+#endif /* !GSM_RTOS && !GSM_ASYNC */
+    }
+}
+
+/* Checks if stack has any internal command to execute */
+gstatic
+uint8_t InternalPending(gvol GSM_t* GSM) {
+#if GSM_CONN_RX_LENGTH
+    if (GSM->ConnRxLength) {
+        return 1;
+    }
+#endif /* GSM_CONN_RX_LENGTH */
+#if GSM_SMS && GSM_SMS_DIRECT
+    if (GSM->SmsDirect != NULL && (GSM->SmsDirect->AckPending || GSM->SmsDirect->NackPending)) {
+        return 1;
+    }
+#endif /* GSM_SMS && GSM_SMS_DIRECT */
+    return GSM->ConnReject != 0;
+}
+
+/* Converts number to string */
+gstatic
+void NumberToString(char* str, uint32_t number) {
+    sprintf(str, "%u", number);
+}
+
+#if GSM_SMS && GSM_SMS_PDU
+/* Sends encoded PDU characters to module */
+gstatic
+void PDUOutput(const void* data, uint16_t len, void* arg) {
+    UART_SEND(data, len);                                   /* Send characters */
+}
+#endif /* GSM_SMS && GSM_SMS_PDU */
+
+/******************************************************************************/
 /******************************************************************************/
-/******************************************************************************/
 /***                              Protothreads                               **/
 /******************************************************************************/
 /******************************************************************************/
@@ -1635,6 +2327,10 @@ gstatic
 PT_THREAD(PT_Thread_SMS(struct pt* pt, gvol GSM_t* GSM)) {
     char terminate = 26;
     char str[6];
+    static uint32_t start;
+#if GSM_SMS_PDU
+    const char* end;
+#endif /* GSM_SMS_PDU */
     GSM_SMS_Entry_t* ReadSMSPtr = (GSM_SMS_Entry_t *)Pointers.Ptr1;
     
     PT_BEGIN(pt);                                           /* Begin thread */
@@ -1716,6 +2412,11 @@ PT_THREAD(PT_Thread_SMS(struct pt* pt, gvol GSM_t* GSM)) {
                             GSM->Events.F.RespError);       /* Wait for response */
         
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+#if GSM_SMS_INDEX
+        if (GSM->Events.F.RespOk) {
+            IndexSet(GSM, Pointers.UI, SMS_INDEX_FREE);     /* Position is empty now */
+        }
+#endif /* GSM_SMS_INDEX */
         __IDLE(GSM);                                        /* Go IDLE mode */
     } else if (GSM->ActiveCmd == CMD_SMS_MASSDELETE) {      /* Process mass delete SMS */
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
@@ -1730,6 +2431,11 @@ PT_THREAD(PT_Thread_SMS(struct pt* pt, gvol GSM_t* GSM)) {
                             GSM->Events.F.RespError);       /* Wait for response */
         
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+#if GSM_SMS_INDEX
+        if (GSM->Events.F.RespOk) {
+            IndexMassDelete(GSM, (GSM_SMS_MassDelete_t)Pointers.UI);    /* Free deleted positions */
+        }
+#endif /* GSM_SMS_INDEX */
         __IDLE(GSM);                                        /* Go IDLE mode */  
     } else if (GSM->ActiveCmd == CMD_SMS_LIST) {            /* Process get all SMS entries */
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
@@ -1743,7 +2449,274 @@ PT_THREAD(PT_Thread_SMS(struct pt* pt, gvol GSM_t* GSM)) {
                             GSM->Events.F.RespError);       /* Wait for response */
         
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        GSM->SmsListCallback = NULL;                        /* Streaming is finished */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_SMS_QUEUE) {           /* Process send queue */
+        while (GSM->SMS.Queue->Head < GSM->SMS.Queue->Count) {
+            GSM->SMS.Number = GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Number;
+            GSM->SMS.Data = GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Data;
+            
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CMGS=\""));           /* Send number to GSM */
+            UART_SEND_STR(GSM->SMS.Number);                 /* Send actual number formatted as string */
+            UART_SEND_STR(FROMMEM("\""));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_SMS_SEND, FROMMEM("+CMGS"));  /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespBracket ||
+                                GSM->Events.F.RespError);   /* Wait for > character and timeout */
+            
+            if (GSM->Events.F.RespBracket) {                /* We received bracket */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(GSM->SMS.Data);               /* Send SMS data */
+                UART_SEND_CH(&terminate);                   /* Send terminate SMS character */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk ||
+                                    GSM->Events.F.RespError);   /* Wait for OK or ERROR */
+            }
+            
+            if (GSM->Events.F.RespOk) {                     /* Message sent */
+                GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Result = gsmOK;
+                GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].MemNum = GSM->SMS.SentSMSMemNum;
+                GSM->SMS.Queue->Sent++;
+            } else if (GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Tries < GSM->SMS.Queue->Retries) {
+                GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Tries++;
+                GSM->SMS.Queue->Retried++;
+                
+                start = GSM->Time;
+                PT_WAIT_UNTIL(pt, GSM->Time - start >= SMS_QUEUE_RETRY_DELAY);  /* Give network some time before retry */
+                continue;                                   /* Try the same message again */
+            } else {
+                GSM->SMS.Queue->Entries[GSM->SMS.Queue->Head].Result = gsmERROR;
+                GSM->SMS.Queue->Failed++;
+            }
+            if (GSM->Time != GSM->SMS.Queue->StartTime) {
+                GSM->SMS.Queue->MessagesPerMinute = (uint32_t)((uint64_t)(GSM->SMS.Queue->Sent + GSM->SMS.Queue->Failed) * 60000 / (GSM->Time - GSM->SMS.Queue->StartTime));
+            }
+            GSM->ActiveResult = GSM->SMS.Queue->Failed ? gsmERROR : gsmOK;  /* Set result to return */
+            if (GSM->SMS.Queue->Head + 1 >= GSM->SMS.Queue->Count) {
+                GSM->SMS.Queue->Head++;                     /* Last message processed */
+                GSM->SMS.QueueDone = 1;                     /* Queue is released by callback processing after last notification */
+                break;                                      /* Do not use queue anymore */
+            }
+            GSM->SMS.Queue->Head++;                         /* Go to next message */
+        }
+        
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#if GSM_SMS_PDU
+    } else if (GSM->ActiveCmd == CMD_SMS_SEND_PDU || GSM->ActiveCmd == CMD_SMS_READ_PDU) {  /* Process PDU mode commands */
+        __CMD_SAVE(GSM);                                    /* Save current command */
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CMGF=0"));                /* Go to SMS PDU mode */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_SMS_CMGF, NULL);              /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmENTERTEXTMODEERROR;
+        if (GSM->ActiveResult != gsmOK) {
+            goto cmd_sms_pdu_clean;
+        }
+        
+        if (GSM->ActiveCmd == CMD_SMS_SEND_PDU) {           /* Send all parts of message */
+            for (GSM->SMS.Part = 1; GSM->SMS.Part <= GSM->SMS.Parts; GSM->SMS.Part++) {
+                NumberToString(str, GSM_PDU_PartLength(GSM->SMS.Number, GSM->SMS.Data, (GSM_PDU_DCS_t)GSM->SMS.DCS, GSM->SMS.Parts, &end));
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+CMGS="));         /* Send length of PDU */
+                UART_SEND_STR(str);
+                UART_SEND_STR(GSM_CRLF);
+                __CMD_SAVE(GSM);                            /* Save current command */
+                StartCommand(GSM, CMD_SMS_SEND, FROMMEM("+CMGS"));  /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespBracket ||
+                                    GSM->Events.F.RespError);   /* Wait for > character and timeout */
+                
+                if (GSM->Events.F.RespBracket) {            /* We received bracket */
+                    __RST_EVENTS_RESP(GSM);                 /* Reset events */
+                    GSM_PDU_PartLength(GSM->SMS.Number, GSM->SMS.Data, (GSM_PDU_DCS_t)GSM->SMS.DCS, GSM->SMS.Parts, &end);
+                    GSM_PDU_WritePart(GSM->SMS.Number, GSM->SMS.Data, end, (GSM_PDU_DCS_t)GSM->SMS.DCS,
+                        GSM->SMS.Ref, GSM->SMS.Part, GSM->SMS.Parts, PDUOutput, NULL);  /* Send encoded part */
+                    UART_SEND_CH(&terminate);               /* Send terminate SMS character */
+                    GSM->SMS.Data = end;                    /* Next part starts here */
+                    
+                    PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk ||
+                                        GSM->Events.F.RespError);   /* Wait for OK or ERROR */
+                }
+                __CMD_RESTORE(GSM);                         /* Restore command */
+                
+                if (!GSM->Events.F.RespOk) {                /* Part was not sent */
+                    GSM->ActiveResult = gsmERROR;
+                    break;
+                }
+            }
+            if (GSM->ActiveResult == gsmOK) {
+                GSM->Flags.F.SMS_SendOk = 1;                /* SMS sent OK */
+            } else {
+                GSM->Flags.F.SMS_SendError = 1;             /* SMS was not send */
+            }
+        } else {                                            /* Read message in PDU mode */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            GSM->SMS.ReadLen = 0;                           /* Reset PDU length */
+            NumberToString(str, GSM->SMS.Position);         /* Convert number to string */
+            UART_SEND_STR(FROMMEM("AT+CMGR="));             /* Send command */
+            UART_SEND_STR(str);
+            UART_SEND_STR(GSM_CRLF);
+            __CMD_SAVE(GSM);                                /* Save current command */
+            StartCommand(GSM, CMD_SMS_CMGR, NULL);          /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            __CMD_RESTORE(GSM);                             /* Restore command */
+            
+            if (GSM->Events.F.RespOk && GSM->SMS.ReadLen) {
+                GSM->ActiveResult = GSM_PDU_Decode((char *)Pointers.Ptr1, (GSM_PDU_t *)Pointers.Ptr2);  /* Decode message in place */
+            } else {
+                GSM->ActiveResult = gsmERROR;               /* Message does not exist */
+            }
+        }
+        
+cmd_sms_pdu_clean:
+        __CMD_SAVE(GSM);                                    /* Save current command */
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CMGF=1"));                /* Go back to SMS text mode */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_SMS_CMGF, NULL);              /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_SMS_PDU */
+#if GSM_SMS_DIRECT
+    } else if (GSM->ActiveCmd == CMD_SMS_DIRECT) {          /* Process direct delivery setup */
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CSMS="));                 /* Select message service */
+        UART_SEND_STR(Pointers.Ptr1 != NULL && ((GSM_SMS_Direct_t *)Pointers.Ptr1)->Ack ? FROMMEM("1") : FROMMEM("0"));
+        UART_SEND_STR(GSM_CRLF);
+        __CMD_SAVE(GSM);                                    /* Save current command */
+        StartCommand(GSM, CMD_SMS_CSMS, NULL);              /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        
+        if (GSM->Events.F.RespOk) {
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            if (Pointers.Ptr1 != NULL) {
+                UART_SEND_STR(FROMMEM("AT+CNMI=2,2,0,0,0"));/* Route new messages directly to us */
+            } else {
+                UART_SEND_STR(FROMMEM("AT+CNMI=2,1,0,0,0"));/* Store new messages and send notification */
+            }
+            UART_SEND_STR(GSM_CRLF);
+            __CMD_SAVE(GSM);                                /* Save current command */
+            StartCommand(GSM, CMD_SMS_CNMI, NULL);          /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            __CMD_RESTORE(GSM);                             /* Restore command */
+        }
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmOK && Pointers.Ptr1 == NULL) {
+            GSM->SmsDirect = NULL;                          /* Direct delivery is disabled */
+        } else if (GSM->ActiveResult != gsmOK) {
+            GSM->SmsDirect = (GSM_SMS_Direct_t *)Pointers.Ptr2; /* Setup failed, restore previous ring buffer */
+        }
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_SMS_DIRECT */
+#if GSM_SMS_CMTI_QUEUE
+    } else if (GSM->ActiveCmd == CMD_SMS_RECONCILE) {       /* List unread messages to find lost notifications */
+        __CMD_SAVE(GSM);                                    /* Save current command */
+        
+        /**** Select memory of received messages ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CPMS=\""));               /* Send command */
+        UART_SEND_STR(SMSMemoryString(GSM->SmsArrivals.Memory));
+        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_SMS_CPMS_SET, NULL);          /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+#if GSM_SMS_INDEX
+        if (GSM->SmsArrivals.Memory != GSM->SmsIndex.Memory) {
+            GSM->SmsIndex.Valid = 0;                        /* Index is for other memory, positions can not be tracked anymore */
+        }
+#endif /* GSM_SMS_INDEX */
+        
+        if (GSM->Events.F.RespOk) {
+            /**** List unread messages ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CMGL=\"REC UNREAD\",1"));/* Do not change status of messages */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_SMS_CMGL, NULL);          /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+        }
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult != gsmOK) {
+            GSM->SmsArrivals.Reconcile = 1;                 /* Listing must be repeated */
+        }
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_SMS_CMTI_QUEUE */
+#if GSM_SMS_INDEX
+    } else if (GSM->ActiveCmd == CMD_SMS_INDEX) {           /* Build index of message storage */
+        GSM->SmsIndex.Valid = 0;                            /* Index is not valid until built */
+        GSM->SmsIndex.Total = 0;
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CPMS?"));                 /* Get size of storage */
+        UART_SEND_STR(GSM_CRLF);
+        __CMD_SAVE(GSM);                                    /* Save current command */
+        StartCommand(GSM, CMD_SMS_CPMS, NULL);              /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk && GSM->SmsIndex.Total && GSM->SmsIndex.Total <= GSM_SMS_INDEX_SIZE ? gsmOK : gsmERROR;
+        if (GSM->ActiveResult == gsmOK) {
+            /**** Select memory of received messages for list, read and delete ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CPMS=\""));           /* Send command */
+            UART_SEND_STR(SMSMemoryString(GSM->SmsIndex.Memory));
+            UART_SEND_STR(FROMMEM("\""));
+            UART_SEND_STR(GSM_CRLF);
+            __CMD_SAVE(GSM);                                /* Save current command */
+            StartCommand(GSM, CMD_SMS_CPMS_SET, NULL);      /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            __CMD_RESTORE(GSM);                             /* Restore command */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR;
+        }
+        if (GSM->ActiveResult == gsmOK) {
+            memset((void *)GSM->SmsIndex.Status, SMS_INDEX_FREE, sizeof(GSM->SmsIndex.Status));
+            GSM->SmsIndex.Valid = 1;                        /* Cleared by positions outside index */
+            
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CMGL=\"ALL\",1"));    /* List all messages, do not change status of messages */
+            UART_SEND_STR(GSM_CRLF);
+            __CMD_SAVE(GSM);                                /* Save current command */
+            StartCommand(GSM, CMD_SMS_CMGL_INDEX, NULL);    /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            __CMD_RESTORE(GSM);                             /* Restore command */
+            
+            if (!GSM->Events.F.RespOk) {
+                GSM->SmsIndex.Valid = 0;
+            }
+            GSM->ActiveResult = GSM->SmsIndex.Valid ? gsmOK : gsmERROR;
+        }
         __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_SMS_INDEX */
     }
     PT_END(pt);                                             /* End thread */
 }
@@ -1883,16 +2856,26 @@ PT_THREAD(PT_Thread_DATETIME(struct pt* pt, gvol GSM_t* GSM)) {
 
 gstatic
 PT_THREAD(PT_Thread_GPRS(struct pt* pt, gvol GSM_t* GSM)) {
-    char str[7];
+    char str[11];
     static uint32_t start, btw;
     static uint8_t tries;
+#if GSM_CONN_QSEND
+    static uint16_t acktries;
+    static uint8_t ackcheck;
+#endif /* GSM_CONN_QSEND */
+#if GSM_CONN_DNS_CACHE
+    static uint8_t dns;
+    GSM_CONN_DNSEntry_t* entry;
+#endif /* GSM_CONN_DNS_CACHE */
     GSM_CONN_t* conn = (GSM_CONN_t *)Pointers.Ptr1;
     uint8_t terminate = 26;
     
     PT_BEGIN(pt);                                           /* Begin thread */
     
     __CMD_SAVE(GSM);                                        /* Save command */
-    GSM_EXECUTE_NETWORK_CHECK(GSM);                         /* Check for network state */
+    if (!__IS_TRANSPARENT_DATA(GSM)) {                      /* Commands can't be sent in data mode */
+        GSM_EXECUTE_NETWORK_CHECK(GSM);                     /* Check for network state */
+    }
     __CMD_RESTORE(GSM);                                     /* Restore command */
 
     if (GSM->ActiveCmd == CMD_GPRS_SETAPN) {                /* Process APN settings */
@@ -1983,6 +2966,48 @@ PT_THREAD(PT_Thread_GPRS(struct pt* pt, gvol GSM_t* GSM)) {
             goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
         }
         
+#if GSM_CONN_TRANSPARENT
+        if (GSM->Flags.F.Transparent) {
+            /**** Set single connection ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CIPMUX=0"));          /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_CIPMUX, NULL);       /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+       
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {
+                goto cmd_gprs_attach_clean;                 /* Clean thread and stop execution */
+            }
+            
+            /**** Set transparent mode ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CIPMODE=1"));         /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_CIPMODE, NULL);      /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+       
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {
+                goto cmd_gprs_attach_clean;                 /* Clean thread and stop execution */
+            }
+            goto cmd_gprs_attach_apn;                       /* Skip multiple connections setup */
+        }
+        
+        /**** Set normal mode ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPMODE=0"));             /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPMODE, NULL);          /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response, ignore it */
+#endif /* GSM_CONN_TRANSPARENT */
+        
         /**** Set multiple connections ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
         UART_SEND_STR(FROMMEM("AT+CIPMUX=1"));              /* Send command */
@@ -1997,6 +3022,35 @@ PT_THREAD(PT_Thread_GPRS(struct pt* pt, gvol GSM_t* GSM)) {
             goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
         }
         
+#if GSM_CONN_RX_DGRAM
+        /**** Receive data automatically ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPRXGET=0"));            /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPRXGET, NULL);         /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+   
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {
+            goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
+        }
+        
+        /**** Add header with length to received data ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPHEAD=1"));             /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPHEAD, NULL);          /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+   
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {
+            goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
+        }
+#else
         /**** Receive data manually ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
         UART_SEND_STR(FROMMEM("AT+CIPRXGET=1"));            /* Send command */
@@ -2009,8 +3063,37 @@ PT_THREAD(PT_Thread_GPRS(struct pt* pt, gvol GSM_t* GSM)) {
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
         if (GSM->ActiveResult == gsmERROR) {
             goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
-        } 
+        }
+#endif /* GSM_CONN_RX_DGRAM */
+        
+        /**** Read maximal data length ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPSEND?"));              /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPSEND_GET, NULL);      /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response, ignore it and use default value on error */
         
+#if GSM_CONN_QSEND
+        /**** Quick send mode ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPQSEND=1"));            /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPQSEND, NULL);         /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+   
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {
+            goto cmd_gprs_attach_clean;                     /* Clean thread and stop execution */
+        }
+#endif /* GSM_CONN_QSEND */
+        
+#if GSM_CONN_TRANSPARENT
+cmd_gprs_attach_apn:
+#endif /* GSM_CONN_TRANSPARENT */
         /**** Set APN data ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
         UART_SEND_STR(FROMMEM("AT+CSTT=\""));               /* Send command */
@@ -2071,6 +3154,9 @@ PT_THREAD(PT_Thread_GPRS(struct pt* pt, gvol GSM_t* GSM)) {
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response, ignore it */
+#if GSM_HTTP && GSM_HTTP_SESSION
+        GSM->HTTP.SessionActive = 0;                        /* HTTP session is not active anymore */
+#endif /* GSM_HTTP && GSM_HTTP_SESSION */
         
         /**** SAPBR start for HTTP ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
@@ -2112,6 +3198,21 @@ cmd_gprs_attach_clean:
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
         
         GSM->Flags.F.Call_GPRS_Detached = 1;                /* Set detached flag */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE */
+    } else if (GSM->ActiveCmd == CMD_GPRS_BEARER) {         /* Open bearer again */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+SAPBR=1,1"));             /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_SAPBR, NULL);            /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE */
     } else if (GSM->ActiveCmd == CMD_GPRS_CIPSTART) {       /* Start new connection as client */
@@ -2127,13 +3228,63 @@ cmd_gprs_attach_clean:
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
         
+#if GSM_CONN_DNS_CACHE
+        /**** Resolve host name ****/
+        dns = 0;                                            /* 1 = cached address, 2 = resolved address, 3 = host name */
+cmd_gprs_cipstart_dns:
+        if (!IsIPAddress((const char *)Pointers.CPtr1)) {
+            entry = dns == 0 ? DNSCacheFind(GSM, (const char *)Pointers.CPtr1) : NULL;
+            if (entry != NULL) {                            /* Use cached address */
+                GSM->DNSCacheHits++;
+                strcpy((char *)GSM->DNSAddr, entry->Addr);
+                dns = 1;
+            } else {
+                GSM->DNSCacheMisses++;
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+CDNSGIP=\""));    /* Send command */
+                UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+                UART_SEND_STR(FROMMEM("\""));
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_CDNSGIP, NULL);  /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+                
+                if (GSM->Events.F.RespOk) {
+                    PT_WAIT_UNTIL(pt, GSM->Events.F.RespDNSOk ||
+                                        GSM->Events.F.RespDNSFail ||
+                                        GSM->Events.F.RespError);   /* Wait for resolved address */
+                }
+                
+                dns = 3;                                    /* Let device resolve host name on failure */
+                if (GSM->Events.F.RespDNSOk) {
+                    DNSCacheInsert(GSM, (const char *)Pointers.CPtr1, (const char *)GSM->DNSAddr);    /* Save address to cache */
+                    dns = 2;
+                }
+            }
+        }
+#endif /* GSM_CONN_DNS_CACHE */
+        
         /**** CIP start ****/
-        NumberToString(str, Pointers.UI);                   /* Convert number to string */
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+CIPSTART=0,\""));         /* Send command */
+        UART_SEND_STR(FROMMEM("AT+CIPSTART="));             /* Send command */
+        if (!__IS_TRANSPARENT(GSM)) {
+            NumberToString(str, conn->ID);                  /* Connection ID in multiple connections mode */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(FROMMEM(","));
+        }
+        NumberToString(str, Pointers.UI);                   /* Convert port number to string */
+        UART_SEND_STR(FROMMEM("\""));
         UART_SEND_STR(FROMMEM(Pointers.CPtr2));             /* TCP/UDP */
         UART_SEND_STR(FROMMEM("\",\""));
-        UART_SEND_STR(FROMMEM(Pointers.CPtr1));             /* Domain/IP */
+#if GSM_CONN_DNS_CACHE
+        if (dns == 1 || dns == 2) {
+            UART_SEND_STR(FROMMEM(GSM->DNSAddr));           /* Resolved IP */
+        } else
+#endif /* GSM_CONN_DNS_CACHE */
+        {
+            UART_SEND_STR(FROMMEM(Pointers.CPtr1));         /* Domain/IP */
+        }
         UART_SEND_STR(FROMMEM("\","));
         UART_SEND_STR(FROMMEM(str));                        /* Port number */
         UART_SEND_STR(GSM_CRLF);
@@ -2150,8 +3301,18 @@ cmd_gprs_attach_clean:
                                 GSM->Events.F.RespConnectAlready); /* Wait for connect response */
             
             if (GSM->Events.F.RespConnectOk) {
-                conn->ID = 0;                               /* Set connection ID */
-                GSM->Conns[0] = (GSM_CONN_t *)Pointers.Ptr1;    /* Save connection pointer */
+                conn->Flags.Value = 0;                      /* Reset all flags */
+                conn->Flags.F.Active = 1;                   /* Connection is active */
+                conn->Flags.F.Opened = 1;
+#if GSM_CONN_QSEND
+                conn->BytesAccepted = 0;                    /* Reset quick send counters */
+                conn->BytesAcked = 0;
+#endif /* GSM_CONN_QSEND */
+#if GSM_CONN_RX_DGRAM
+                conn->RxIn = conn->RxOut = 0;               /* Drop data of previous connection */
+                conn->RxDropped = 0;
+#endif /* GSM_CONN_RX_DGRAM */
+                GSM->Conns[conn->ID] = conn;                /* Save connection pointer */
             }
             
             if (GSM->Events.F.RespConnectFail) {            /* Check if connection was successful */
@@ -2159,22 +3320,72 @@ cmd_gprs_attach_clean:
             }
         }
         
+#if GSM_CONN_DNS_CACHE
+        if (GSM->ActiveResult != gsmOK && dns == 1) {       /* Cached address failed, resolve host name again */
+            entry = DNSCacheFind(GSM, (const char *)Pointers.CPtr1);
+            if (entry != NULL) {
+                entry->Host[0] = 0;                         /* Remove entry from cache */
+            }
+            goto cmd_gprs_cipstart_dns;
+        }
+#endif /* GSM_CONN_DNS_CACHE */
+#if GSM_CONN_POOL
+        if (GSM->ConnPoolStart != NULL && &GSM->ConnPoolStart->Conn == conn) {  /* Connection was started from pool */
+            if (GSM->ActiveResult == gsmOK && conn->Flags.F.Active) {
+                *GSM->ConnPoolOut = conn;                   /* Give connection to user */
+            } else {
+                GSM->ConnPoolStart->InUse = 0;              /* Entry is free again */
+            }
+            GSM->ConnPoolStart = NULL;
+            GSM->ConnPoolOut = NULL;
+        }
+#endif /* GSM_CONN_POOL */
+        
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE */
     } else if (GSM->ActiveCmd == CMD_GPRS_CIPCLOSE) {       /* Close client connection */
         __CMD_SAVE(GSM);                                    /* Save command */
         
-        NumberToString(str, Pointers.UI);                   /* Convert number to string */
+#if GSM_CONN_TRANSPARENT
+        if (GSM->Flags.F.TransparentData) {                 /* Leave data mode first */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            start = GSM->Time;
+            PT_WAIT_UNTIL(pt, (GSM->Time - start >= 1000 && !BUFFER_GetFull(&Buffer)) ||
+                                !GSM->Flags.F.TransparentData || 
+                                GSM->Events.F.RespError);   /* Guard time before escape sequence, user must read all data */
+            
+            if (GSM->Events.F.RespError) {                  /* Received data were not read, stay in data mode */
+                GSM->ActiveResult = gsmTIMEOUT;
+                __CMD_RESTORE(GSM);                         /* Restore command */
+                __IDLE(GSM);                                /* Go IDLE */
+                PT_EXIT(pt);                                /* Exit thread */
+            }
+            if (GSM->Flags.F.TransparentData) {             /* Connection was not closed by remote side meanwhile */
+                GSM->Flags.F.TransparentData = 0;           /* Parse responses again */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("+++"));              /* Send escape sequence */
+                StartCommand(GSM, CMD_GPRS_TRANSPARENT_EXIT, NULL); /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+            }
+        }
+#endif /* GSM_CONN_TRANSPARENT */
         
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+CIPCLOSE=0"));            /* Send command */
+        UART_SEND_STR(FROMMEM("AT+CIPCLOSE"));              /* Send command */
+        if (!__IS_TRANSPARENT(GSM)) {
+            NumberToString(str, conn->ID);                  /* Connection ID in multiple connections mode */
+            UART_SEND_STR(FROMMEM("="));
+            UART_SEND_STR(FROMMEM(str));
+        }
         UART_SEND_STR(GSM_CRLF);
         StartCommand(GSM, CMD_GPRS_CIPCLOSE, NULL);         /* Start command */
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespError || 
                             GSM->Events.F.RespCloseOk);     /* Wait for response */
         
-        GSM->Conns[0]->Flags.F.Active = 0;                  /* Connection is not active anymore */
+        conn->Flags.F.Active = 0;                           /* Connection is not active anymore */
         
         GSM->ActiveResult = GSM->Events.F.RespCloseOk ? gsmOK : gsmERROR; /* Set result to return */
         
@@ -2187,12 +3398,49 @@ cmd_gprs_attach_clean:
         }
         
         tries = 3;                                          /* Give 3 tries to send each packet */
+#if GSM_CONN_QSEND
+        acktries = CONN_QSEND_ACK_TRIES;                    /* Give remote side some time to acknowledge full window */
+        ackcheck = 1;                                       /* Window is checked until device reports it is not supported */
+#endif /* GSM_CONN_QSEND */
         do {            
-            btw = Pointers.UI > 1460 ? 1460 : Pointers.UI;  /* Set length to send */
+            btw = CONN_SEGMENT_SIZE(GSM, conn);             /* Get maximal length for connection */
+            if (btw > Pointers.UI) {
+                btw = Pointers.UI;                          /* Set length to send */
+            }
             
-            NumberToString(str, btw);                       /* Get string from number */
+#if GSM_CONN_QSEND
+            if (ackcheck && conn->BytesAccepted - conn->BytesAcked + btw > GSM_CONN_QSEND_WINDOW) { /* Send window is full */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+CIPACK="));       /* Check acknowledged data */
+                NumberToString(str, conn->ID);
+                UART_SEND_STR(FROMMEM(str));
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_CIPACK, NULL);   /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk ||
+                                    GSM->Events.F.RespError);   /* Wait for response */
+                
+                if (GSM->Events.F.RespError) {              /* Acknowledge is not tracked for this connection */
+                    ackcheck = 0;
+                } else if (conn->BytesAccepted - conn->BytesAcked + btw > GSM_CONN_QSEND_WINDOW) {  /* Still no space in window */
+                    start = GSM->Time;
+                    PT_WAIT_UNTIL(pt, GSM->Time - start >= 200);    /* Give remote side some time to acknowledge data */
+                    if (!--acktries) {                      /* Remote side does not acknowledge anything */
+                        GSM->ActiveResult = gsmTIMEOUT;
+                        break;
+                    }
+                    continue;
+                } else {
+                    acktries = CONN_QSEND_ACK_TRIES;        /* Reset number of acknowledge checks */
+                }
+            }
+#endif /* GSM_CONN_QSEND */
             __RST_EVENTS_RESP(GSM);                         /* Reset events */
-            UART_SEND_STR(FROMMEM("AT+CIPSEND=0,"));        /* Send number to GSM */
+            UART_SEND_STR(FROMMEM("AT+CIPSEND="));          /* Send number to GSM */
+            NumberToString(str, conn->ID);                  /* Connection ID */
+            UART_SEND_STR(str);
+            UART_SEND_STR(FROMMEM(","));
+            NumberToString(str, btw);                       /* Get string from number */
             UART_SEND_STR(str);
             UART_SEND_STR(GSM_CRLF);
             StartCommand(GSM, CMD_GPRS_CIPSEND, NULL);      /* Start command */
@@ -2204,12 +3452,20 @@ cmd_gprs_attach_clean:
                 __RST_EVENTS_RESP(GSM);                     /* Reset events */
                 UART_SEND((uint8_t *)Pointers.CPtr1, btw);  /* Send data */
                 UART_SEND_CH(&terminate);
+                start = GSM->Time;                          /* Start measuring send time */
                 
                 PT_WAIT_UNTIL(pt, GSM->Events.F.RespSendOk ||
+#if GSM_CONN_QSEND
+                                    GSM->Events.F.RespDataAccept ||
+#endif /* GSM_CONN_QSEND */
                                     GSM->Events.F.RespSendFail ||
                                     GSM->Events.F.RespError);   /* Wait for OK or ERROR */
                 
+#if GSM_CONN_QSEND
+                GSM->ActiveResult = GSM->Events.F.RespDataAccept ? gsmOK : gsmSENDFAIL; /* Set result to return */
+#else
                 GSM->ActiveResult = GSM->Events.F.RespSendOk ? gsmOK : gsmSENDFAIL; /* Set result to return */
+#endif /* GSM_CONN_QSEND */
                 
                 if (GSM->ActiveResult == gsmOK) {
                     if (Pointers.Ptr2 != NULL) {
@@ -2224,21 +3480,262 @@ cmd_gprs_attach_clean:
                 
                 Pointers.UI -= btw;                         /* Decrease number of sent bytes */
                 Pointers.CPtr1 = (uint8_t *)Pointers.CPtr1 + btw;   /* Set new data memory location to send */
+                
+                conn->SendLatency = GSM->Time - start;      /* Save time needed to send packet */
+#if GSM_CONN_SEGMENT_AUTO
+                if (btw == CONN_SEGMENT_SIZE(GSM, conn) && conn->SegmentSize < CONN_SEGMENT_LIMIT(GSM, conn)) {  /* Full segment sent, try with bigger one */
+                    conn->SegmentSize += CONN_SEGMENT_SIZE_STEP;
+                    if (conn->SegmentSize > CONN_SEGMENT_LIMIT(GSM, conn)) {
+                        conn->SegmentSize = CONN_SEGMENT_LIMIT(GSM, conn);
+                    }
+                }
+#endif /* GSM_CONN_SEGMENT_AUTO */
             } else {
                 tries--;                                    /* We failed, decrease number of tries and start over */
+#if GSM_CONN_SEGMENT_AUTO
+                if (GSM->Events.F.RespSendFail && CONN_SEGMENT_SIZE(GSM, conn) > CONN_SEGMENT_SIZE_MIN) {  /* Send failed, use smaller segments */
+                    conn->SegmentSize = CONN_SEGMENT_SIZE(GSM, conn) / 2;
+                    if (conn->SegmentSize < CONN_SEGMENT_SIZE_MIN) {
+                        conn->SegmentSize = CONN_SEGMENT_SIZE_MIN;
+                    }
+                }
+#endif /* GSM_CONN_SEGMENT_AUTO */
             }
         } while (Pointers.UI && tries);                     /* Until anything to send */
+        conn->Flags.F.SendError = GSM->ActiveResult != gsmOK;   /* Save send status for poll */
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_CIPSERVER) {      /* Start or stop server */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        if (Pointers.UI) {
+            UART_SEND_STR(FROMMEM("AT+CIPSERVER=1,"));      /* Start server on port */
+            NumberToString(str, Pointers.UI & 0xFFFF);
+            UART_SEND_STR(FROMMEM(str));
+        } else {
+            UART_SEND_STR(FROMMEM("AT+CIPSERVER=0"));       /* Stop server */
+        }
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPSERVER, NULL);        /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmOK && Pointers.UI) {
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespServerOk ||
+                                GSM->Events.F.RespError);   /* Wait for server to start listening */
+            
+            GSM->ActiveResult = GSM->Events.F.RespServerOk ? gsmOK : gsmERROR;
+            if (GSM->ActiveResult == gsmOK) {
+                GSM->ServerConns = (GSM_CONN_t *)Pointers.Ptr1; /* Accept new connections now */
+                GSM->ServerConnsCount = Pointers.UI >> 16;
+            }
+        }
+        if (GSM->ActiveResult == gsmOK && !Pointers.UI) {
+            GSM->ServerConns = NULL;                        /* Stop accepting new connections */
+            GSM->ServerConnsCount = 0;
+        }
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_CIPSEND_DGRAM) {  /* Send multiple datagrams */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+#if GSM_CONN_QSEND
+        acktries = CONN_QSEND_ACK_TRIES;                    /* Give remote side some time to acknowledge full window */
+        ackcheck = 1;                                       /* Window is checked until device reports it is not supported */
+#endif /* GSM_CONN_QSEND */
+        btw = 0;
+        while (btw < Pointers.UI) {                         /* Process all datagrams */
+#if GSM_CONN_QSEND
+            if (ackcheck && conn->BytesAccepted - conn->BytesAcked + ((const GSM_CONN_Datagram_t *)Pointers.CPtr1)[btw].Length > GSM_CONN_QSEND_WINDOW) {   /* Send window is full */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+CIPACK="));       /* Check acknowledged data */
+                NumberToString(str, conn->ID);
+                UART_SEND_STR(FROMMEM(str));
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_CIPACK, NULL);   /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk ||
+                                    GSM->Events.F.RespError);   /* Wait for response */
+                
+                if (GSM->Events.F.RespError) {              /* Acknowledge is not tracked for this connection */
+                    ackcheck = 0;
+                } else if (conn->BytesAccepted - conn->BytesAcked + ((const GSM_CONN_Datagram_t *)Pointers.CPtr1)[btw].Length > GSM_CONN_QSEND_WINDOW) {  /* Still no space in window */
+                    start = GSM->Time;
+                    PT_WAIT_UNTIL(pt, GSM->Time - start >= 200);    /* Give remote side some time to acknowledge data */
+                    if (!--acktries) {                      /* Remote side does not acknowledge anything */
+                        GSM->ActiveResult = gsmTIMEOUT;
+                        break;
+                    }
+                    continue;                               /* Check same datagram again */
+                } else {
+                    acktries = CONN_QSEND_ACK_TRIES;        /* Reset number of acknowledge checks */
+                }
+            }
+#endif /* GSM_CONN_QSEND */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+CIPSEND="));          /* Send command */
+            NumberToString(str, conn->ID);                  /* Connection ID */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(FROMMEM(","));
+            NumberToString(str, ((const GSM_CONN_Datagram_t *)Pointers.CPtr1)[btw].Length);  /* Datagram length */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_CIPSEND, NULL);      /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespBracket ||
+                                GSM->Events.F.RespError);   /* Wait for > character and timeout */
+            
+            if (GSM->Events.F.RespError) {
+                GSM->ActiveResult = gsmERROR;               /* Process error */
+                break;
+            }
+            
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND(((const GSM_CONN_Datagram_t *)Pointers.CPtr1)[btw].Data, ((const GSM_CONN_Datagram_t *)Pointers.CPtr1)[btw].Length);  /* Send datagram */
+            UART_SEND_CH(&terminate);
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespSendOk ||
+#if GSM_CONN_QSEND
+                                GSM->Events.F.RespDataAccept ||
+#endif /* GSM_CONN_QSEND */
+                                GSM->Events.F.RespSendFail ||
+                                GSM->Events.F.RespError);   /* Wait for OK or ERROR */
+            
+#if GSM_CONN_QSEND
+            GSM->ActiveResult = GSM->Events.F.RespDataAccept ? gsmOK : gsmSENDFAIL; /* Set result to return */
+#else
+            GSM->ActiveResult = GSM->Events.F.RespSendOk ? gsmOK : gsmSENDFAIL; /* Set result to return */
+#endif /* GSM_CONN_QSEND */
+            if (GSM->ActiveResult != gsmOK) {               /* Stop on first failed datagram */
+                break;
+            }
+            if (Pointers.Ptr2 != NULL) {
+                *(uint16_t *)Pointers.Ptr2 = (*(uint16_t *)Pointers.Ptr2) + 1;  /* Increase number of sent datagrams */
+            }
+            btw++;                                          /* Go to next datagram */
+        }
+        conn->Flags.F.SendError = GSM->ActiveResult != gsmOK;   /* Save send status for poll */
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#if GSM_CONN_QSEND
+    } else if (GSM->ActiveCmd == CMD_GPRS_CIPACK) {         /* Check acknowledged data on connection */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPACK="));               /* Send command */
+        NumberToString(str, conn->ID);                      /* Convert number to string for connection ID */
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_CIPACK, NULL);           /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmOK && Pointers.Ptr2 != NULL) {
+            *(uint32_t *)Pointers.Ptr2 = conn->BytesAcked;  /* Save number of acknowledged bytes */
+        }
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_CONN_QSEND */
+#if GSM_CONN_TRANSPARENT
+    } else if (GSM->ActiveCmd == CMD_GPRS_TRANSPARENT_EXIT) {   /* Leave data mode */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        if (GSM->Flags.F.TransparentData) {                 /* Leave data mode first */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            start = GSM->Time;
+            PT_WAIT_UNTIL(pt, (GSM->Time - start >= 1000 && !BUFFER_GetFull(&Buffer)) ||
+                                !GSM->Flags.F.TransparentData || 
+                                GSM->Events.F.RespError);   /* Guard time before escape sequence, user must read all data */
+            
+            if (GSM->Flags.F.TransparentData && !GSM->Events.F.RespError) {    /* Still in data mode and all data were read */
+                GSM->Flags.F.TransparentData = 0;           /* Parse responses again */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("+++"));              /* Send escape sequence */
+                StartCommand(GSM, CMD_GPRS_TRANSPARENT_EXIT, NULL); /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+            } else if (!GSM->Flags.F.TransparentData) {     /* Remote side closed connection, device is in command mode */
+                GSM->Events.F.RespOk = 1;
+            }
+        }
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_TRANSPARENT_RESUME) { /* Go back to data mode */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("ATO"));                      /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_TRANSPARENT_RESUME, NULL);   /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespConnectOk ? gsmOK : gsmERROR; /* Set result to return */
         
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE mode */
+#endif /* GSM_CONN_TRANSPARENT */
     } else if (GSM->ActiveCmd == CMD_GPRS_CIPRXGET) {       /* Read data from device */
         __CMD_SAVE(GSM);                                    /* Save command */
 
         start = GSM->Time;                                  /* Start counting */
         PT_WAIT_UNTIL(pt, GSM->Time - start >= conn->ReadTimeout);  /* Wait start timeout */
         
-        if (conn->BytesToRead > 1460) {                     /* Check max read size */
-            conn->BytesToRead = 1460;
+#if GSM_CONN_RX_DGRAM
+        conn->BytesRead = ConnRxRead(conn, conn->ReceiveData, conn->BytesToRead);  /* Data were already pushed by module */
+        conn->BytesReadTotal += conn->BytesRead;            /* Increase number of total read bytes */
+        if (Pointers.Ptr2 != NULL) {
+            *(uint32_t *)Pointers.Ptr2 = conn->BytesRead;   /* Save number of read bytes in last request */
+        }
+        GSM->ActiveResult = gsmOK;
+        goto cmd_gprs_ciprxget_clean;
+#endif /* GSM_CONN_RX_DGRAM */
+        
+        if (conn->BytesToRead > CONN_READ_SIZE_MAX) {       /* Check max read size */
+            conn->BytesToRead = CONN_READ_SIZE_MAX;
+        }
+        
+        if (Pointers.UI) {                                  /* Read only data waiting in module */
+            if (!conn->Flags.F.RxLengthKnown) {
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+CIPRXGET=4,"));   /* Read number of waiting bytes */
+                NumberToString(str, conn->ID);
+                UART_SEND_STR(FROMMEM(str));
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_CIPRXGET_LEN, NULL); /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+                
+                if (GSM->Events.F.RespError) {
+                    GSM->ActiveResult = gsmERROR;
+                    goto cmd_gprs_ciprxget_clean;
+                }
+            }
+            if (conn->BytesToRead > conn->BytesRemaining) { /* Read only waiting bytes */
+                conn->BytesToRead = conn->BytesRemaining;
+            }
+            if (!conn->BytesToRead) {                       /* Nothing to read */
+                GSM->ActiveResult = gsmOK;
+                if (Pointers.Ptr2 != NULL) {
+                    *(uint32_t *)Pointers.Ptr2 = 0;
+                }
+                goto cmd_gprs_ciprxget_clean;
+            }
         }
         
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
@@ -2261,6 +3758,7 @@ cmd_gprs_attach_clean:
                 *(uint32_t *)Pointers.Ptr2 = conn->BytesRead;   /* Save number of read bytes in last request */
             }
         }        
+cmd_gprs_ciprxget_clean:
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE mode */
 #if GSM_HTTP
@@ -2293,6 +3791,10 @@ cmd_gprs_attach_clean:
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
         
 cmd_gprs_httpbegin_clean:
+#if GSM_HTTP_SESSION
+        GSM->HTTP.SessionActive = GSM->ActiveResult == gsmOK;   /* Session is active now */
+        GSM->HTTP.ParamsValid = 0;                          /* Parameters are not set yet */
+#endif /* GSM_HTTP_SESSION */
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE */
     } else if (GSM->ActiveCmd == CMD_GPRS_HTTPSEND) {       /* Send data to HTTP buffer */
@@ -2329,34 +3831,140 @@ cmd_gprs_httpbegin_clean:
 cmd_gprs_httpsend_clean:                                    /* Clean everything */
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE */ 
-    } else if (GSM->ActiveCmd == CMD_GPRS_HTTPEXECUTE) {    /* Execute command */
+    } else if (GSM->ActiveCmd == CMD_GPRS_HTTPSEND_STREAM) {    /* Send data from producer to HTTP buffer */
         __CMD_SAVE(GSM);                                    /* Save command */
         
-        /**** HTTP PARA URL ****/
+        /**** HTTP DATA ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+HTTPPARA=\"URL\",\""));   /* Send command */
-        UART_SEND_STR(FROMMEM(GSM->HTTP.TMP));
-        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(FROMMEM("AT+HTTPDATA="));             /* Send command */
+        NumberToString(str, Pointers.UI);                   /* Send total data length */
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(FROMMEM(","));
+        start = HTTP_DATA_TIME_MIN + (uint32_t)((uint64_t)Pointers.UI * 1000 / GSM_HTTP_STREAM_RATE);
+        if (start > HTTP_DATA_TIME_MAX) {                   /* Input time is what module waits after producer stops */
+            start = HTTP_DATA_TIME_MAX;
+        }
+        NumberToString(str, start);
+        UART_SEND_STR(FROMMEM(str));
         UART_SEND_STR(GSM_CRLF);
-        StartCommand(GSM, CMD_GPRS_HTTPPARA, NULL);         /* Start command */
+        StartCommand(GSM, CMD_GPRS_HTTPDATA, NULL);         /* Start command */
         
-        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespDownload ||
+                            GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
         
-        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
-        if (GSM->ActiveResult == gsmERROR) {                /* Check for errors */
-            goto cmd_gprs_httpexecute_clean;                  
+        if (GSM->Events.F.RespError || !GSM->Events.F.RespDownload) {
+            GSM->ActiveResult = gsmERROR;
+            goto cmd_gprs_httpsend_stream_clean;
         }
         
-        /**** HTTP SSL ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+HTTPSSL="));              /* Send command */
-        UART_SEND_STR(FROMMEM(Pointers.CPtr1));
-        UART_SEND_STR(GSM_CRLF);
-        StartCommand(GSM, CMD_GPRS_HTTPSSL, NULL);          /* Start command */
+        tries = 0;                                          /* Producer did not stop yet */
+        for (btw = 0; btw < Pointers.UI; ) {                /* Send body chunk by chunk */
+            uint32_t len = Pointers.UI - btw, ret;
+            if (len > GSM->HTTP.DataLength) {               /* Limit to chunk buffer size */
+                len = GSM->HTTP.DataLength;
+            }
+            ret = GSM->HTTP.Producer(GSM->HTTP.Data, len, btw, Pointers.UI);  /* Get data from user */
+            if (!ret) {                                     /* User stopped upload */
+                tries = 1;
+                break;
+            } else if (ret < len) {                         /* Never send more than requested */
+                len = ret;
+            }
+            UART_SEND(GSM->HTTP.Data, len);                 /* Send chunk to module */
+            btw += len;
+            StartCommand(GSM, CMD_GPRS_HTTPDATA, NULL);     /* Restart timeout */
+            
+            start = GSM->Time;
+            PT_WAIT_UNTIL(pt, GSM->Time != start);          /* Process received data between chunks */
+        }
         
+        if (tries) {                                        /* Module stays in input mode until input time expires */
+            start = GSM->ActiveCmdTimeout;
+            GSM->ActiveCmdTimeout = HTTP_DATA_TIME_MAX + 1000;
+        }
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (tries) {
+            GSM->ActiveCmdTimeout = start;                  /* Restore timeout for next steps */
+            
+            /**** Terminate HTTP to clear partial body ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPTERM"));          /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPTERM, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response, ignore it */
+            
+            /**** HTTP INIT ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPINIT"));          /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPINIT, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            if (GSM->Events.F.RespOk) {
+                /**** HTTP PARAMETER CID ****/
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+HTTPPARA=\"CID\",1"));    /* Send command */
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_HTTPINIT, NULL); /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+            }
+#if GSM_HTTP_SESSION
+            GSM->HTTP.SessionActive = GSM->Events.F.RespOk; /* HTTP service is ready for next request */
+            GSM->HTTP.ParamsValid = 0;                      /* Parameters were cleared */
+#endif /* GSM_HTTP_SESSION */
+            GSM->ActiveResult = gsmABORTED;                 /* User stopped upload */
+        }
+        
+cmd_gprs_httpsend_stream_clean:
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE */ 
+    } else if (GSM->ActiveCmd == CMD_GPRS_HTTPEXECUTE) {    /* Execute command */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        /**** HTTP PARA URL ****/
+        if (Pointers.UI & 0x01) {                           /* URL has to be sent */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPPARA=\"URL\",\""));   /* Send command */
+            UART_SEND_STR(FROMMEM(GSM->HTTP.TMP));
+            UART_SEND_STR(FROMMEM("\""));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPPARA, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {            /* Check for errors */
+                goto cmd_gprs_httpexecute_clean;                  
+            }
+        }
+        
+        /**** HTTP SSL ****/
+        if (Pointers.UI & 0x02) {                           /* SSL has to be sent */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPSSL="));          /* Send command */
+            UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPSSL, NULL);      /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {            /* SSL state on module is not known, send it again next time */
+                goto cmd_gprs_httpexecute_clean;                  
+            }
+        }
 
         /**** HTTP METHOD ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
@@ -2378,7 +3986,56 @@ cmd_gprs_httpsend_clean:                                    /* Clean everything
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespHttpAction);    /* Wait for response */
         
+#if GSM_HTTP_SESSION
+        if (GSM->HTTP.Code == 601) {                        /* Network error, bearer might be closed */
+            /**** SAPBR start for HTTP ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+SAPBR=1,1"));         /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_SAPBR, NULL);        /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response, ignore it when already opened */
+            
+            /**** Terminate HTTP ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPTERM"));          /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPTERM, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response, ignore it */
+            
+            /**** HTTP INIT ****/
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPINIT"));          /* Send command */
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPINIT, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            if (GSM->Events.F.RespOk) {
+                /**** HTTP PARAMETER CID ****/
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                UART_SEND_STR(FROMMEM("AT+HTTPPARA=\"CID\",1"));    /* Send command */
+                UART_SEND_STR(GSM_CRLF);
+                StartCommand(GSM, CMD_GPRS_HTTPINIT, NULL); /* Start command */
+                
+                PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                    GSM->Events.F.RespError);   /* Wait for response */
+            }
+            
+            /* Request is not repeated, module lost content, user data and body set before, they have to be set again by user */
+            GSM->HTTP.SessionActive = GSM->Events.F.RespOk; /* HTTP service is ready for next request */
+            GSM->ActiveResult = gsmERROR;                   /* Request failed */
+        }
+#endif /* GSM_HTTP_SESSION */
+        
 cmd_gprs_httpexecute_clean:                                 /* Clean everything */
+#if GSM_HTTP_SESSION
+        GSM->HTTP.ParamsValid = GSM->ActiveResult == gsmOK; /* Parameters on module are known after successful request */
+#endif /* GSM_HTTP_SESSION */
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE */
     } else if (GSM->ActiveCmd == CMD_GPRS_HTTPREAD) {       /* Read data HTTP response */
@@ -2405,6 +4062,63 @@ cmd_gprs_httpexecute_clean:                                 /* Clean everything
             }
         }
         
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_HTTPREAD_STREAM) {    /* Read complete HTTP response to sink */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        GSM->ActiveResult = gsmOK;
+        while (GSM->HTTP.BytesReadTotal < GSM->HTTP.BytesReceived) {
+            GSM->HTTP.BytesToRead = GSM->HTTP.BytesReceived - GSM->HTTP.BytesReadTotal;
+            if (GSM->HTTP.BytesToRead > GSM->HTTP.DataLength) { /* Limit chunk to buffer size */
+                GSM->HTTP.BytesToRead = GSM->HTTP.DataLength;
+            }
+            
+            GSM->HTTP.BytesRead = 0;                        /* Nothing read in this request yet */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+HTTPREAD="));         /* Send command */
+            NumberToString(str, GSM->HTTP.BytesReadTotal);  /* Read from current position */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(FROMMEM(","));
+            NumberToString(str, GSM->HTTP.BytesToRead);     /* Convert number to string */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_HTTPREAD, NULL);     /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            if (GSM->Events.F.RespError || !GSM->HTTP.BytesRead) {
+                GSM->ActiveResult = gsmERROR;               /* Stop on error */
+                break;
+            }
+            if (!GSM->HTTP.Sink(GSM->HTTP.Data, GSM->HTTP.BytesRead, GSM->HTTP.BodyOffset + GSM->HTTP.BytesReadTotal, GSM->HTTP.BodyOffset + GSM->HTTP.BytesReceived)) {
+                GSM->ActiveResult = gsmABORTED;             /* User stopped reading */
+                break;
+            }
+            GSM->HTTP.BytesReadTotal += GSM->HTTP.BytesRead;/* Increase number of total read bytes accepted by user */
+        }
+        if (GSM->ActiveResult == gsmOK) {
+            GSM->HTTP.Sink(NULL, 0, GSM->HTTP.BodyOffset + GSM->HTTP.BytesReadTotal, GSM->HTTP.BodyOffset + GSM->HTTP.BytesReceived); /* Notify about end of response */
+        }
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_HTTPUSERDATA) {  /* Set user defined header */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+HTTPPARA=\"USERDATA\",\""));  /* Send command */
+        UART_SEND_STR(FROMMEM(GSM->HTTP.TMP));
+        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_HTTPPARA, NULL);         /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE mode */
     } else if (GSM->ActiveCmd == CMD_GPRS_HTTPCONTENT) {    /* Read data HTTP response */
@@ -2434,6 +4148,9 @@ cmd_gprs_httpexecute_clean:                                 /* Clean everything
                             GSM->Events.F.RespError);       /* Wait for response */
         
         GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+#if GSM_HTTP_SESSION
+        GSM->HTTP.SessionActive = 0;                        /* Session is closed */
+#endif /* GSM_HTTP_SESSION */
         
         __IDLE(GSM);                                        /* Go IDLE mode */
 #endif /* GSM_HTTP */
@@ -2564,13 +4281,31 @@ cmd_gprs_ftpauth_clean:                                     /* Clean everything
     } else if (GSM->ActiveCmd == CMD_GPRS_FTPDOWNBEGIN) {   /* Begin with download, set folder and file */
         __CMD_SAVE(GSM);                                    /* Save command */
         
-        /**** Set upload path ****/
+        /**** Set download path ****/
+        if (Pointers.CPtr1 != NULL) {                       /* Keep previous path when not set */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+FTPGETPATH=\""));     /* Send command */
+            UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+            UART_SEND_STR(FROMMEM("\""));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPGETPATH, NULL);   /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {            /* Check for errors */
+                goto cmd_gprs_ftpdownbegin_clean;
+            }
+        }
+        
+        /**** Set download name ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+FTPGETPATH=\""));         /* Send command */
-        UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+        UART_SEND_STR(FROMMEM("AT+FTPGETNAME=\""));         /* Send command */
+        UART_SEND_STR(FROMMEM(Pointers.CPtr2));
         UART_SEND_STR(FROMMEM("\""));
         UART_SEND_STR(GSM_CRLF);
-        StartCommand(GSM, CMD_GPRS_FTPGETPATH, NULL);       /* Start command */
+        StartCommand(GSM, CMD_GPRS_FTPGETNAME, NULL);       /* Start command */
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
@@ -2580,13 +4315,30 @@ cmd_gprs_ftpauth_clean:                                     /* Clean everything
             goto cmd_gprs_ftpdownbegin_clean;
         }
         
-        /**** Set download name ****/
+        /**** Set start position ****/
+        if (Pointers.UI) {
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            NumberToString(str, Pointers.UI);
+            UART_SEND_STR(FROMMEM("AT+FTPREST="));          /* Send command */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPREST, NULL);      /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {            /* Check for errors */
+                goto cmd_gprs_ftpdownbegin_clean;
+            }
+        }
+        
+#if GSM_FTP_EXTGET
+        /**** Download file to module memory ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+FTPGETNAME=\""));         /* Send command */
-        UART_SEND_STR(FROMMEM(Pointers.CPtr2));
-        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(FROMMEM("AT+FTPEXTGET=1"));           /* Send command */
         UART_SEND_STR(GSM_CRLF);
-        StartCommand(GSM, CMD_GPRS_FTPGETNAME, NULL);       /* Start command */
+        StartCommand(GSM, CMD_GPRS_FTPEXTGET, NULL);        /* Start command */
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
@@ -2596,6 +4348,34 @@ cmd_gprs_ftpauth_clean:                                     /* Clean everything
             goto cmd_gprs_ftpdownbegin_clean;
         }
         
+        /* Wait +FTPEXTGET response when file is downloaded */
+        start = GSM->ActiveCmdTimeout;                      /* Complete file is transferred in this step */
+        GSM->ActiveCmdTimeout = GSM_FTP_EXTGET_TIMEOUT;
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespFtpExtGet || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        GSM->ActiveCmdTimeout = start;                      /* Restore timeout for next steps */
+        
+        if (!GSM->Events.F.RespFtpExtGet || GSM->FTP.ErrorCode != 0) {
+            GSM->ActiveResult = gsmERROR;
+            goto cmd_gprs_ftpdownbegin_clean;
+        }
+        
+        /**** Get size of file in module memory ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+FTPEXTGET?"));            /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPEXTGETSIZE, NULL);    /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmOK) {
+            GSM->FTP.ExtPosition = 0;                       /* Read from beginning of memory */
+            GSM->FTP.Flags.F.DataAvailable = GSM->FTP.FileSize > 0;
+            GSM->FTP.Flags.F.DownloadActive = 1;            /* Download session is active */
+        }
+#else
         /**** Start FTP download ****/
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
         UART_SEND_STR(FROMMEM("AT+FTPGET=1"));              /* Send command */
@@ -2625,6 +4405,7 @@ cmd_gprs_ftpauth_clean:                                     /* Clean everything
                 }
             }
         }
+#endif /* GSM_FTP_EXTGET */
         
 cmd_gprs_ftpdownbegin_clean:                                /* Clean everything */
         __CMD_RESTORE(GSM);                                 /* Restore command */
@@ -2633,11 +4414,22 @@ cmd_gprs_ftpdownbegin_clean:                                /* Clean everything
         __CMD_SAVE(GSM);                                    /* Save command */
         
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
+#if GSM_FTP_EXTGET
+        NumberToString(str, GSM->FTP.ExtPosition);
+        UART_SEND_STR(FROMMEM("AT+FTPEXTGET=3,"));          /* Send command */
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(FROMMEM(","));
+        NumberToString(str, GSM->FTP.BytesToProcess);
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPEXTGET, NULL);        /* Start command */
+#else
         NumberToString(str, GSM->FTP.BytesToProcess);
         UART_SEND_STR(FROMMEM("AT+FTPGET=2,"));             /* Send command */
         UART_SEND_STR(FROMMEM(str));
         UART_SEND_STR(GSM_CRLF);
         StartCommand(GSM, CMD_GPRS_FTPGET, NULL);           /* Start command */
+#endif /* GSM_FTP_EXTGET */
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
@@ -2647,21 +4439,108 @@ cmd_gprs_ftpdownbegin_clean:                                /* Clean everything
             if (GSM->FTP.BytesRead != GSM->FTP.BytesToProcess || GSM->FTP.BytesRead == 0) {
                 GSM->FTP.Flags.F.DataAvailable = 0;         /* No data available anyomre */
             }
+#if GSM_FTP_EXTGET
+            GSM->FTP.ExtPosition += GSM->FTP.BytesRead;     /* Set next read position */
+            GSM->FTP.Flags.F.DataAvailable = GSM->FTP.ExtPosition < GSM->FTP.FileSize;
+            GSM->FTP.Flags.F.DownloadActive = GSM->FTP.Flags.F.DataAvailable;
+#endif /* GSM_FTP_EXTGET */
             GSM->FTP.BytesProcessedTotal += GSM->FTP.BytesRead; /* Increase number of total read bytes */
             if (Pointers.Ptr1 != NULL) {
                 *(uint32_t *)Pointers.Ptr1 = GSM->FTP.BytesRead;/* Save number of read bytes for user */
             }
         }
         
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_FTPDOWN_STREAM) { /* Read FTP data to sink */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        GSM->ActiveResult = gsmOK;
+        GSM->FTP.Flags.F.Aborted = 0;
+        while (1) {
+            if (!GSM->FTP.Flags.F.DownloadActive) {         /* Transfer finished with +FTPGET: 1,0 */
+                break;
+            }
+            if (!GSM->FTP.Flags.F.DataAvailable) {          /* Wait for module to report new data */
+                __RST_EVENTS_RESP(GSM);                     /* Reset events */
+                GSM->ActiveCmdStart = GSM->Time;            /* Start timeout */
+                PT_WAIT_UNTIL(pt, GSM->FTP.Flags.F.DataAvailable || 
+                                    !GSM->FTP.Flags.F.DownloadActive ||
+                                    (GSM->FTP.Mode == 1 && GSM->FTP.ErrorCode > 1) ||
+                                    GSM->Events.F.RespError);   /* Wait for +FTPGET: 1,x or timeout */
+                
+                if (!GSM->FTP.Flags.F.DataAvailable) {
+                    if (GSM->FTP.Flags.F.DownloadActive) {  /* Error or timeout */
+                        GSM->ActiveResult = gsmERROR;
+                    }
+                    break;
+                }
+            }
+            
+            GSM->FTP.Flags.F.DataAvailable = 0;             /* Set again by +FTPGET: 1,1 or by full chunk */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+#if GSM_FTP_EXTGET
+            NumberToString(str, GSM->FTP.ExtPosition);
+            UART_SEND_STR(FROMMEM("AT+FTPEXTGET=3,"));      /* Send command */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(FROMMEM(","));
+            NumberToString(str, GSM->FTP.BytesToProcess);
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPEXTGET, NULL);    /* Start command */
+#else
+            NumberToString(str, GSM->FTP.BytesToProcess);
+            UART_SEND_STR(FROMMEM("AT+FTPGET=2,"));         /* Send command */
+            UART_SEND_STR(FROMMEM(str));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPGET, NULL);       /* Start command */
+#endif /* GSM_FTP_EXTGET */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            if (GSM->Events.F.RespError) {
+                if (GSM->FTP.Flags.F.DownloadActive) {      /* Error after +FTPGET: 1,0 is end of file */
+                    GSM->ActiveResult = gsmERROR;           /* Stop on error */
+                }
+                break;
+            }
+            if (GSM->FTP.BytesRead == GSM->FTP.BytesToProcess) {
+                GSM->FTP.Flags.F.DataAvailable = 1;         /* Full chunk, more data may be waiting */
+            }
+#if GSM_FTP_EXTGET
+            GSM->FTP.ExtPosition += GSM->FTP.BytesRead;     /* Set next read position */
+            GSM->FTP.Flags.F.DataAvailable = GSM->FTP.ExtPosition < GSM->FTP.FileSize;
+            GSM->FTP.Flags.F.DownloadActive = GSM->FTP.Flags.F.DataAvailable;
+#endif /* GSM_FTP_EXTGET */
+            if (GSM->FTP.BytesRead) {
+                if (!GSM->FTP.Sink(GSM->FTP.Data, GSM->FTP.BytesRead, GSM->FTP.BytesProcessedTotal)) {
+                    GSM->FTP.Flags.F.Aborted = 1;
+                    GSM->ActiveResult = gsmERROR;           /* User stopped reading */
+                    break;
+                }
+                GSM->FTP.BytesProcessedTotal += GSM->FTP.BytesRead; /* Increase number of total read bytes */
+            }
+        }
+        if (GSM->ActiveResult == gsmOK) {
+            GSM->FTP.Sink(NULL, 0, GSM->FTP.BytesProcessedTotal);   /* Notify about end of file */
+        }
+        
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE mode */
     } else if (GSM->ActiveCmd == CMD_GPRS_FTPDOWNEND) {     /* Finish with FTP downloading */
         __CMD_SAVE(GSM);                                    /* Save command */
         
         __RST_EVENTS_RESP(GSM);                             /* Reset events */
+#if GSM_FTP_EXTGET
+        UART_SEND_STR(FROMMEM("AT+FTPEXTGET=0"));           /* Release module memory */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPEXTGET, NULL);        /* Start command */
+#else
         UART_SEND_STR(FROMMEM("AT+FTPGET=1,0"));            /* Send command */
         UART_SEND_STR(GSM_CRLF);
         StartCommand(GSM, CMD_GPRS_FTPGET, NULL);           /* Start command */
+#endif /* GSM_FTP_EXTGET */
         
         PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
                             GSM->Events.F.RespError);       /* Wait for response */
@@ -2691,19 +4570,21 @@ cmd_gprs_ftpdownbegin_clean:                                /* Clean everything
         
         
         /**** Set upload path ****/
-        __RST_EVENTS_RESP(GSM);                             /* Reset events */
-        UART_SEND_STR(FROMMEM("AT+FTPPUTPATH=\""));         /* Send command */
-        UART_SEND_STR(FROMMEM(Pointers.CPtr1));
-        UART_SEND_STR(FROMMEM("\""));
-        UART_SEND_STR(GSM_CRLF);
-        StartCommand(GSM, CMD_GPRS_FTPPUTPATH, NULL);       /* Start command */
-        
-        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
-                            GSM->Events.F.RespError);       /* Wait for response */
-        
-        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
-        if (GSM->ActiveResult == gsmERROR) {                /* Check for errors */
-            goto cmd_gprs_ftpupbegin_clean;
+        if (Pointers.CPtr1 != NULL) {                       /* Keep previous path when not set */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+FTPPUTPATH=\""));     /* Send command */
+            UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+            UART_SEND_STR(FROMMEM("\""));
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPPUTPATH, NULL);   /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            
+            GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+            if (GSM->ActiveResult == gsmERROR) {            /* Check for errors */
+                goto cmd_gprs_ftpupbegin_clean;
+            }
         }
         
         /**** Set upload name ****/
@@ -2803,12 +4684,133 @@ cmd_gprs_ftpupbegin_clean:                                  /* Clean everything
             }
             if (GSM->ActiveResult == gsmOK) {
                 GSM->FTP.BytesToProcess -= btw;             /* Decrease number of sent bytes */
-                Pointers.CPtr1 = (uint8_t *)Pointers.CPtr1 + btw;   /* Set new data memory location to send */
+                GSM->FTP.Data += btw;                       /* Set new data memory location to send */
             }
         } while (GSM->FTP.BytesToProcess && GSM->ActiveResult == gsmOK);    /* Until anything to send */
         
         __CMD_RESTORE(GSM);                                 /* Restore command */
         __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_FTPUP_STREAM) {   /* Send FTP data from producer */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        GSM->ActiveResult = gsmOK;
+        GSM->FTP.StartTime = GSM->Time;
+        GSM->FTP.Flags.F.Stage = 0;
+        GSM->FTP.StageLength[0] = GSM->FTP.Producer(GSM->FTP.Data, GSM->FTP.BytesToProcess, GSM->FTP.BytesProcessedTotal);  /* Fill first buffer */
+        while (GSM->FTP.StageLength[GSM->FTP.Flags.F.Stage]) {
+            btw = GSM->FTP.StageLength[GSM->FTP.Flags.F.Stage]; /* Set length to send */
+            if (btw > GSM->FTP.BytesToProcess) {            /* Never send more than staging buffer and module limit */
+                btw = GSM->FTP.BytesToProcess;
+            }
+            
+            NumberToString(str, btw);                       /* Get string from number */
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND_STR(FROMMEM("AT+FTPPUT=2,"));         /* Send number to GSM */
+            UART_SEND_STR(str);
+            UART_SEND_STR(GSM_CRLF);
+            StartCommand(GSM, CMD_GPRS_FTPPUT, NULL);       /* Start command */
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespFtpUploadReady ||
+                                GSM->Events.F.RespError);   /* Wait for FTP upload ready or error */
+            
+            if (!GSM->Events.F.RespFtpUploadReady) {
+                GSM->ActiveResult = gsmERROR;               /* Process error */
+                break;
+            }
+            __RST_EVENTS_RESP(GSM);                         /* Reset events */
+            UART_SEND((uint8_t *)GSM->FTP.Data + GSM->FTP.Flags.F.Stage * GSM->FTP.BytesToProcess, btw);   /* Send data */
+            
+            /* Fill second buffer while module sends data to server */
+            GSM->FTP.StageLength[!GSM->FTP.Flags.F.Stage] = GSM->FTP.Producer(
+                GSM->FTP.Data + !GSM->FTP.Flags.F.Stage * GSM->FTP.BytesToProcess, GSM->FTP.BytesToProcess, GSM->FTP.BytesProcessedTotal + btw);
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                                GSM->Events.F.RespError);   /* Wait for response */
+            if (GSM->Events.F.RespError) {
+                GSM->ActiveResult = gsmERROR;
+                break;
+            }
+            
+            PT_WAIT_UNTIL(pt, GSM->Events.F.RespFtpPut || 
+                                GSM->Events.F.RespError);   /* Wait for another FTPPUT */
+            
+            if (!GSM->Events.F.RespFtpPut || GSM->FTP.Mode != 1 || GSM->FTP.ErrorCode != 1) {
+                GSM->ActiveResult = gsmERROR;               /* Server is not ready for more data */
+                break;
+            }
+            
+            GSM->FTP.BytesProcessedTotal += btw;            /* Increase number of uploaded bytes */
+            if (GSM->Time != GSM->FTP.StartTime) {
+                GSM->FTP.BytesPerSecond = (uint32_t)((uint64_t)GSM->FTP.BytesProcessedTotal * 1000 / (GSM->Time - GSM->FTP.StartTime));
+            }
+            GSM->FTP.Flags.F.CallProgress = 1;              /* Notify user about progress */
+            GSM->FTP.Flags.F.Stage = !GSM->FTP.Flags.F.Stage;   /* Send second buffer next */
+        }
+        
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go IDLE mode */
+    } else if (GSM->ActiveCmd == CMD_GPRS_FTPGETSIZE) {     /* Get file size */
+        __CMD_SAVE(GSM);                                    /* Save command */
+        
+        /**** Set file path ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+FTPGETPATH=\""));         /* Send command */
+        UART_SEND_STR(FROMMEM(Pointers.CPtr1));
+        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPGETPATH, NULL);       /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {                /* Check for errors */
+            goto cmd_gprs_ftpgetsize_clean;
+        }
+        
+        /**** Set file name ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+FTPGETNAME=\""));         /* Send command */
+        UART_SEND_STR(FROMMEM(Pointers.CPtr2));
+        UART_SEND_STR(FROMMEM("\""));
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPGETNAME, NULL);       /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {                /* Check for errors */
+            goto cmd_gprs_ftpgetsize_clean;
+        }
+        
+        /**** Get file size ****/
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+FTPSIZE"));               /* Send command */
+        UART_SEND_STR(GSM_CRLF);
+        StartCommand(GSM, CMD_GPRS_FTPSIZE, NULL);          /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = GSM->Events.F.RespOk ? gsmOK : gsmERROR; /* Set result to return */
+        if (GSM->ActiveResult == gsmERROR) {                /* Check for errors */
+            goto cmd_gprs_ftpgetsize_clean;
+        }
+        
+        /* Wait +FTPSIZE response */
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespFtpSize || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+        
+        GSM->ActiveResult = gsmERROR;
+        if (GSM->Events.F.RespFtpSize && GSM->FTP.ErrorCode == 0) { /* Size received */
+            *(uint32_t *)Pointers.Ptr1 = GSM->FTP.FileSize; /* Save size for user */
+            GSM->ActiveResult = gsmOK;
+        }
+        
+cmd_gprs_ftpgetsize_clean:                                  /* Clean everything */
+        __CMD_RESTORE(GSM);                                 /* Restore command */
+        __IDLE(GSM);                                        /* Go idle mode */
     } else if (GSM->ActiveCmd == CMD_GPRS_FTPUPEND) {       /* Finish with FTP uploading */
         __CMD_SAVE(GSM);                                    /* Save command */
         
@@ -2917,8 +4919,81 @@ PT_THREAD(PT_Thread_OP(struct pt* pt, gvol GSM_t* GSM)) {
     PT_END(pt);
 }
 
+/* Commands started by stack on its own when no user command is active */
+gstatic
+PT_THREAD(PT_Thread_INTERNAL(struct pt* pt, gvol GSM_t* GSM)) {
+    char str[4];
+    static GSM_Result_t result;
+    static uint8_t num;
+    
+    PT_BEGIN(pt);                                           /* Begin thread */
+    result = GSM->ActiveResult;                             /* Keep result of last user command */
+    
+#if GSM_SMS && GSM_SMS_DIRECT
+    if (GSM->SmsDirect != NULL && (GSM->SmsDirect->AckPending || GSM->SmsDirect->NackPending)) { /* Acknowledge directly delivered SMS first, module waits only few seconds */
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        if (GSM->SmsDirect->AckPending) {
+            GSM->SmsDirect->AckPending--;                   /* Acknowledge is sent only once */
+            UART_SEND_STR(FROMMEM("AT+CNMA"));              /* Message stored, positive acknowledge */
+        } else {
+            GSM->SmsDirect->NackPending--;
+            UART_SEND_STR(FROMMEM("AT+CNMA=2"));            /* Message not stored, negative acknowledge so network delivers it again */
+        }
+        UART_SEND_STR(GSM_CRLF);
+        StartInternal(GSM, CMD_INTERNAL_CNMA, 1000);        /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+    } else
+#endif /* GSM_SMS && GSM_SMS_DIRECT */
+    if (GSM->ConnReject) {                                  /* Close connections which could not be accepted */
+        for (num = 0; !(GSM->ConnReject & (1 << num)); num++);
+        GSM->ConnReject &= ~(1 << num);
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPCLOSE="));             /* Send command */
+        NumberToString(str, num);
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(GSM_CRLF);
+        StartInternal(GSM, CMD_INTERNAL_CIPCLOSE, 1000);    /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespCloseOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+#if GSM_CONN_RX_LENGTH
+    } else if (GSM->ConnRxLength) {                         /* Read number of waiting bytes before new data notification */
+        for (num = 0; !(GSM->ConnRxLength & (1 << num)); num++);
+        GSM->ConnRxLength &= ~(1 << num);
+        
+        __RST_EVENTS_RESP(GSM);                             /* Reset events */
+        UART_SEND_STR(FROMMEM("AT+CIPRXGET=4,"));           /* Send command */
+        NumberToString(str, num);
+        UART_SEND_STR(FROMMEM(str));
+        UART_SEND_STR(GSM_CRLF);
+        StartInternal(GSM, CMD_INTERNAL_CIPRXGET_LEN, 1000);    /* Start command */
+        
+        PT_WAIT_UNTIL(pt, GSM->Events.F.RespOk || 
+                            GSM->Events.F.RespError);       /* Wait for response */
+#endif /* GSM_CONN_RX_LENGTH */
+    }
+    
+    GSM->ActiveResult = result;                             /* Restore result */
+    __INTERNAL_IDLE(GSM);                                   /* Go IDLE mode */
+    PT_END(pt);                                             /* End thread */
+}
+
 /* Process all thread calls */
 GSM_Result_t ProcessThreads(gvol GSM_t* GSM) {
+    if (GSM->ActiveCmd == CMD_IDLE && !__IS_TRANSPARENT_DATA(GSM) && InternalPending(GSM)) {
+        GSM->InternalActive = 1;                            /* Reserve stack for internal command */
+        if (GSM->CmdRequest || GSM->ActiveCmd != CMD_IDLE) {
+            GSM->InternalActive = 0;                        /* User command is starting, try again later */
+        } else {
+            GSM->ActiveCmd = CMD_INTERNAL;
+        }
+    }
+    if (CMD_IS_ACTIVE_INTERNAL(GSM)) {                      /* Internal commands */
+        PT_Thread_INTERNAL(&pt_INTERNAL, GSM);
+    }
     if (CMD_IS_ACTIVE_GENERAL(GSM)) {                       /* General related commands */
         PT_Thread_GEN(&pt_GEN, GSM);                       
     }
@@ -2980,6 +5055,7 @@ GSM_Result_t GSM_Init(gvol GSM_t* G, const char* pin, uint32_t Baudrate, GSM_Eve
     
     /* Set start values */
     GSM->CPIN = GSM_CPIN_Unknown;                           /* Force SIM checking */
+    GSM->ConnMaxSegmentSize = CONN_SEGMENT_SIZE_DEFAULT;    /* Set default segment size until read from device */
 #if GSM_CALL
     GSM->CallInfo.State = GSM_CallState_Disconnect;         /* Set default call state */
 #endif /* GSM_CALL */
@@ -3126,14 +5202,75 @@ GSM_Result_t GSM_Update(gvol GSM_t* GSM) {
         GSM->Events.F.RespError = 1;                        /* Set active error and process */
     }
     
+#if GSM_CONN_TRANSPARENT
+    if (__IS_TRANSPARENT_DATA(GSM)) {                       /* Check raw data for remote close notification */
+        if (!GSM->TransparentClosed && Buff->In != GSM->TransparentScanned) {
+            while (GSM->TransparentScanned != Buff->In) {   /* Check only new data, byte by byte */
+                ch = Buff->Buffer[GSM->TransparentScanned];
+                if (GSM->TransparentMatch == TRANSPARENT_CLOSED_LENGTH) {   /* Data after notification, it was part of payload */
+                    GSM->TransparentMatch = 0;
+                }
+                if (ch == TRANSPARENT_CLOSED[GSM->TransparentMatch]) {
+                    if (!GSM->TransparentMatch) {
+                        GSM->TransparentMatchStart = GSM->TransparentScanned;
+                    }
+                    GSM->TransparentMatch++;
+                } else if (ch == TRANSPARENT_CLOSED[0]) {  /* Notification may start here */
+                    GSM->TransparentMatchStart = GSM->TransparentScanned;
+                    GSM->TransparentMatch = 1;
+                } else {
+                    GSM->TransparentMatch = 0;
+                }
+                if (++GSM->TransparentScanned >= Buff->Size) {
+                    GSM->TransparentScanned = 0;
+                }
+            }
+            GSM->TransparentRxTime = GSM->Time;             /* Data received now */
+        } else if (GSM->TransparentMatch && GSM->Time - GSM->TransparentRxTime >= TRANSPARENT_CLOSED_IDLE) {
+            if (GSM->TransparentMatch == TRANSPARENT_CLOSED_LENGTH) {   /* Notification was last received data, device is in command mode */
+                GSM->TransparentClosed = 1;
+                GSM->TransparentLeft = (GSM->TransparentMatchStart + Buff->Size - Buff->Out) % Buff->Size;  /* User can still read data received before notification */
+                if (GSM->Conns[0]) {
+                    GSM->Conns[0]->Flags.F.Active = 0;
+                    GSM->Conns[0]->Flags.F.CallConnClosed = 1;
+                }
+            }
+            GSM->TransparentMatch = 0;                      /* Partial match followed by idle line is payload */
+        }
+        if (GSM->TransparentClosed && !GSM->TransparentLeft) {  /* All data were read, go back to command mode */
+            uint8_t tmp[TRANSPARENT_CLOSED_LENGTH];
+            BUFFER_Read(Buff, tmp, sizeof(tmp));            /* Remove notification from buffer */
+            GSM->TransparentClosed = 0;
+            GSM->Flags.F.TransparentData = 0;               /* Parse responses again */
+        }
+    }
+#endif /* GSM_CONN_TRANSPARENT */
+    
     while (
 #if !GSM_RTOS && GSM_ASYNC
         processedCount-- &&
 #else
         processedCount &&
 #endif
+        !__IS_TRANSPARENT_DATA(GSM) &&                      /* In data mode, user reads data directly from buffer */
         BUFFER_Read(Buff, (uint8_t *)&ch, 1)                /* Read single character from buffer */
     ) {
+#if GSM_CONN_RX_DGRAM
+        if (GSM->Flags.F.CLIENT_Recv_Data) {                /* Packet data pushed by module */
+            GSM_CONN_t* conn = GSM->ConnRxConn;
+            if (conn != NULL) {
+                conn->RxBuff[GSM->ConnRxPos++ % conn->RxSize] = ch; /* Save character */
+            }
+            if (!--GSM->ConnRxRemaining) {                  /* We finished? */
+                GSM->Flags.F.CLIENT_Recv_Data = 0;          /* Reset flag, go back to normal parsing */
+                if (conn != NULL) {
+                    conn->RxIn = GSM->ConnRxPos;            /* Packet is available to user */
+                    conn->Flags.F.RxGetReceived = 1;        /* Data are waiting */
+                    conn->Flags.F.CallGetReceived = 1;      /* Notify user with callback */
+                }
+            }
+        } else
+#endif /* GSM_CONN_RX_DGRAM */
 #if GSM_HTTP
         if (GSM->ActiveCmd == CMD_GPRS_HTTPREAD && GSM->Flags.F.HTTP_Read_Data) { /* We are trying to read raw data? */
             GSM->HTTP.Data[GSM->HTTP.BytesRead++] = ch;     /* Save character */
@@ -3145,7 +5282,7 @@ GSM_Result_t GSM_Update(gvol GSM_t* GSM) {
         } else 
 #endif /* GSM_HTTP */
 #if GSM_FTP
-        if (GSM->ActiveCmd == CMD_GPRS_FTPGET && GSM->Flags.F.FTP_Read_Data) {
+        if ((GSM->ActiveCmd == CMD_GPRS_FTPGET || GSM->ActiveCmd == CMD_GPRS_FTPEXTGET) && GSM->Flags.F.FTP_Read_Data) {
             GSM->FTP.Data[GSM->FTP.BytesRead++] = ch;       /* Save character */
             GSM->FTP.BytesReadRemaining--;                  /* Decrease number of remaining bytes to read */
             if (!GSM->FTP.BytesReadRemaining) {             /* We finished? */
@@ -3166,6 +5303,38 @@ GSM_Result_t GSM_Update(gvol GSM_t* GSM) {
             }
         } else
 #if GSM_SMS
+#if GSM_SMS_DIRECT
+        if (GSM->Flags.F.SMS_CMT_Read_Data) {               /* We are reading data of directly delivered SMS */
+            gvol GSM_SMS_Direct_t* direct = GSM->SmsDirect;
+            GSM_SMS_Entry_t* read = NULL;
+            if (!GSM->Flags.F.SMS_CMT_Drop && direct != NULL) {
+                read = &direct->Entries[direct->In % direct->Size]; /* Entry parsed from +CMT header */
+                if (read->DataLen < (sizeof(read->Data) - 1)) { /* Still memory available? */
+                    read->Data[read->DataLen++] = ch;       /* Save character */
+                }
+            }
+            if (ch == '\n' && prev1_ch == '\r') {           /* We finished? */
+                if (read != NULL) {
+                    while (read->DataLen && (read->Data[read->DataLen - 1] == '\r' || read->Data[read->DataLen - 1] == '\n')) {
+                        read->DataLen--;                    /* Remove CRLF characters */
+                    }
+                    read->Data[read->DataLen] = 0;          /* Finish this statement */
+                    direct->In++;                           /* Message is available to user */
+                    GSM->Flags.F.SMS_CMT_Received = 1;      /* Set flag for callback */
+                    if (direct->Ack) {
+                        direct->AckPending++;               /* Acknowledge only stored messages, network delivers dropped ones again */
+                    }
+                } else if (direct != NULL) {
+                    direct->Dropped++;                      /* Message is lost */
+                    if (direct->Ack) {
+                        direct->NackPending++;              /* Every message must be acknowledged, otherwise module disables direct delivery */
+                    }
+                }
+                GSM->Flags.F.SMS_CMT_Read_Data = 0;         /* Reset flag, stop further processing */
+                processedCount = 0;                         /* Stop further processing */
+            }
+        } else
+#endif /* GSM_SMS_DIRECT */
         if (GSM->ActiveCmd == CMD_SMS_READ && GSM->Flags.F.SMS_Read_Data) {  /* We are execution SMS read command and we are trying to read actual SMS data */
             GSM_SMS_Entry_t* read = (GSM_SMS_Entry_t *) Pointers.Ptr1;  /* Read pointer and cast to SMS entry */
             if (read->DataLen < (sizeof(read->Data) - 1)) { /* Still memory available? */
@@ -3179,21 +5348,57 @@ GSM_Result_t GSM_Update(gvol GSM_t* GSM) {
                 GSM->Flags.F.SMS_Read_Data = 0;             /* Reset flag, stop further processing */
                 processedCount = 0;                         /* Stop further processing */
             }
-        } else if (GSM->ActiveCmd == CMD_SMS_LIST && GSM->Flags.F.SMS_Read_Data) {   /* We received data for SMS as list command */
-            if (*(uint16_t *)Pointers.Ptr2 < Pointers.UI) { /* If there is still memory available */
-                GSM_SMS_Entry_t* read = (GSM_SMS_Entry_t *) Pointers.Ptr1;  /* Read pointer and cast to SMS entry */
-                if (read->DataLen < (sizeof(read->Data) - 1)) {
-                    read->Data[read->DataLen++] = ch;           /* Save character */
-                }
-                if (ch == '\n' && prev1_ch == '\r' && read->DataLen >= 2) { /* We finished? */
-                    read->DataLen -= 2;                     /* Remove CRLF characters */
-                    read->Data[read->DataLen] = 0;          /* Finish this statement */
-                    
-                    Pointers.Ptr1 = (GSM_SMS_Entry_t *)Pointers.Ptr1 + 1;  /* Increase pointer */ 
-                    *(uint16_t *)Pointers.Ptr2 = (*(uint16_t *)Pointers.Ptr2) + 1;  /* Increase number of parsed elements */
-                    
-                    GSM->Flags.F.SMS_Read_Data = 0;         /* Clear flag, no more reading data */
-                    processedCount = 0;                     /* Stop further processing */
+#if GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX
+        } else if ((GSM->ActiveCmd == CMD_SMS_CMGL || GSM->ActiveCmd == CMD_SMS_CMGL_INDEX) && GSM->Flags.F.SMS_Read_Data) {  /* Ignore data of listed message */
+            if (ch == '\n' && prev1_ch == '\r') {           /* We finished? */
+                GSM->Flags.F.SMS_Read_Data = 0;             /* Reset flag, stop further processing */
+                processedCount = 0;                         /* Stop further processing */
+            }
+#endif /* GSM_SMS_CMTI_QUEUE || GSM_SMS_INDEX */
+#if GSM_SMS_PDU
+        } else if (GSM->ActiveCmd == CMD_SMS_CMGR && GSM->Flags.F.SMS_Read_Data) {  /* We are reading PDU of SMS */
+            if (ch == '\n') {                               /* We finished? */
+                ((char *)Pointers.Ptr1)[GSM->SMS.ReadLen] = 0;  /* Finish this statement */
+                GSM->Flags.F.SMS_Read_Data = 0;             /* Reset flag, stop further processing */
+                processedCount = 0;                         /* Stop further processing */
+            } else if (ch != '\r' && GSM->SMS.ReadLen < (Pointers.UI - 1)) {  /* Still memory available? */
+                ((char *)Pointers.Ptr1)[GSM->SMS.ReadLen++] = ch;   /* Save character */
+            }
+#endif /* GSM_SMS_PDU */
+        } else if (GSM->ActiveCmd == CMD_SMS_LIST && GSM->SmsListCallback != NULL && GSM->Flags.F.SMS_Read_Data) {  /* We received data for SMS as streaming list command */
+            GSM_SMS_Entry_t* read = (GSM_SMS_Entry_t *) Pointers.Ptr1;  /* Read pointer and cast to SMS entry */
+            if (!GSM->SmsListStop && read->DataLen < (sizeof(read->Data) - 1)) {
+                read->Data[read->DataLen++] = ch;           /* Save character */
+            }
+            if (ch == '\n' && prev1_ch == '\r') {           /* We finished? */
+                if (!GSM->SmsListStop) {
+                    while (read->DataLen && (read->Data[read->DataLen - 1] == '\r' || read->Data[read->DataLen - 1] == '\n')) {
+                        read->DataLen--;                    /* Remove CRLF characters */
+                    }
+                    read->Data[read->DataLen] = 0;          /* Finish this statement */
+                    *(uint16_t *)Pointers.Ptr2 = (*(uint16_t *)Pointers.Ptr2) + 1;  /* Increase number of parsed elements */
+                    if (!GSM->SmsListCallback(read, GSM->SmsListArg)) { /* Pass message to user */
+                        GSM->SmsListStop = 1;               /* Ignore remaining messages */
+                    }
+                }
+                GSM->Flags.F.SMS_Read_Data = 0;             /* Clear flag, no more reading data */
+                processedCount = 0;                         /* Stop further processing */
+            }
+        } else if (GSM->ActiveCmd == CMD_SMS_LIST && GSM->Flags.F.SMS_Read_Data) {   /* We received data for SMS as list command */
+            if (*(uint16_t *)Pointers.Ptr2 < Pointers.UI) { /* If there is still memory available */
+                GSM_SMS_Entry_t* read = (GSM_SMS_Entry_t *) Pointers.Ptr1;  /* Read pointer and cast to SMS entry */
+                if (read->DataLen < (sizeof(read->Data) - 1)) {
+                    read->Data[read->DataLen++] = ch;           /* Save character */
+                }
+                if (ch == '\n' && prev1_ch == '\r' && read->DataLen >= 2) { /* We finished? */
+                    read->DataLen -= 2;                     /* Remove CRLF characters */
+                    read->Data[read->DataLen] = 0;          /* Finish this statement */
+                    
+                    Pointers.Ptr1 = (GSM_SMS_Entry_t *)Pointers.Ptr1 + 1;  /* Increase pointer */ 
+                    *(uint16_t *)Pointers.Ptr2 = (*(uint16_t *)Pointers.Ptr2) + 1;  /* Increase number of parsed elements */
+                    
+                    GSM->Flags.F.SMS_Read_Data = 0;         /* Clear flag, no more reading data */
+                    processedCount = 0;                     /* Stop further processing */
                 }
             } else if (ch == '\n' && prev1_ch == '\r') {    /* Process dummy read, ignore messages if no memory specified buy still finish reading when done */
                 GSM->Flags.F.SMS_Read_Data = 0;             /* Clear flag, no more reading data */
@@ -3266,6 +5471,26 @@ GSM_Result_t GSM_ProcessCallbacks(gvol GSM_t* GSM) {
         GSM->Flags.F.SMS_CMTI_Received = 0;
         __CALL_CALLBACK(GSM, gsmEventSMSCMTI);
     }
+#if GSM_SMS_DIRECT
+    if (__IS_READY(GSM) && GSM->Flags.F.SMS_CMT_Received) {
+        GSM->Flags.F.SMS_CMT_Received = 0;
+        GSM->CallbackParams.CP1 = GSM->SmsDirect;
+        __CALL_CALLBACK(GSM, gsmEventSMSCMT);
+    }
+#endif /* GSM_SMS_DIRECT */
+    if (GSM->SMS.Queue != NULL) {                           /* Called during queue processing */
+        GSM_SMS_Queue_t* queue = GSM->SMS.Queue;            /* Queue stays valid until all entries are notified */
+        uint8_t done = GSM->SMS.QueueDone;                  /* Read before entries, last entry is final when set */
+        while (queue->Notified < queue->Head) {
+            GSM->CallbackParams.CP1 = &queue->Entries[queue->Notified];
+            GSM->CallbackParams.CP2 = queue;
+            __CALL_CALLBACK(GSM, gsmEventSMSQueueSent);
+            queue->Notified++;
+        }
+        if (done && queue->Notified == queue->Head) {       /* Sending finished and everything reported */
+            GSM->SMS.Queue = NULL;                          /* Queue is not used by stack anymore */
+        }
+    }
 #endif /* GSM_SMS */
     if (__IS_READY(GSM) && GSM->Flags.F.Call_GPRS_Attached) {
         GSM->Flags.F.Call_GPRS_Attached = 0;
@@ -3287,17 +5512,37 @@ GSM_Result_t GSM_ProcessCallbacks(gvol GSM_t* GSM) {
         GSM->Flags.F.Call_UV_PD = 0;
         __CALL_CALLBACK(GSM, gsmEventUVPowerDown);
     }
+#if GSM_FTP
+    if (GSM->FTP.Flags.F.CallProgress) {                    /* Called during transfer */
+        GSM->FTP.Flags.F.CallProgress = 0;
+        GSM->CallbackParams.CP1 = (GSM_FTP_t *)&GSM->FTP;
+        GSM->CallbackParams.UI = GSM->FTP.BytesProcessedTotal;
+        __CALL_CALLBACK(GSM, gsmEventFTPProgress);
+    }
+#endif /* GSM_FTP */
     /* Check connection specific callbacks */
     for (i = 0; i < 6; i++) {
         if (!GSM->Conns[i]) {                               /* Check if connection is valid */
             continue;
         }
         if (__IS_READY(GSM) && GSM->Conns[i]->Flags.F.CallGetReceived) {  /* Notify user about new data */
+#if GSM_CONN_RX_LENGTH
+            if (GSM->ConnRxLength & (1 << i)) {             /* Stack reads number of waiting bytes first */
+                continue;
+            }
+#endif /* GSM_CONN_RX_LENGTH */
             GSM->Conns[i]->Flags.F.CallGetReceived = 0;     /* Reset flag status */
             
             GSM->CallbackParams.CP1 = GSM->Conns[i];        /* Set connection parameters */
+            GSM->CallbackParams.UI = GSM->Conns[i]->Flags.F.RxLengthKnown ? GSM->Conns[i]->BytesRemaining : 0;
             __CALL_CALLBACK(GSM, gsmEventDataReceived);     /* Call user function */
         }
+        if (__IS_READY(GSM) && GSM->Conns[i]->Flags.F.CallAccepted) {   /* Notify user about accepted connection */
+            GSM->Conns[i]->Flags.F.CallAccepted = 0;        /* Reset flag status */
+            
+            GSM->CallbackParams.CP1 = GSM->Conns[i];        /* Set connection parameters */
+            __CALL_CALLBACK(GSM, gsmEventConnAccepted);     /* Call user function */
+        }
     }
     __RETURN(GSM, gsmOK);
 }
@@ -3593,22 +5838,32 @@ GSM_Result_t GSM_SMS_List(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, GSM_SMS_Entr
     
     *entries_read = 0;                                      /* Reset variable */
     
-    switch (type) {                                         /* Check for proper type */
-        case GSM_SMS_ReadType_READ:     Pointers.CPtr1 = FROMMEM("REC READ");   break;
-        case GSM_SMS_ReadType_UNREAD:   Pointers.CPtr1 = FROMMEM("REC UNREAD"); break;
-        case GSM_SMS_ReadType_SENT:     Pointers.CPtr1 = FROMMEM("STO SENT"); break;
-        case GSM_SMS_ReadType_UNSENT:   Pointers.CPtr1 = FROMMEM("STO UNSENT"); break;
-        case GSM_SMS_ReadType_ALL:
-        default: 
-            Pointers.CPtr1 = FROMMEM("ALL");
-    }
+    Pointers.CPtr1 = SMSReadTypeString(type);               /* Save type of messages to list */
     Pointers.Ptr1 = entries;                                /* Save pointer to entries */
     Pointers.Ptr2 = entries_read;                           /* Save pointer to entries we already read */
     Pointers.UI = entries_count;                            /* Save number of entries we can save in entries */
+    GSM->SmsListCallback = NULL;                            /* No streaming */
     
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking possibility */
 }
 
+GSM_Result_t GSM_SMS_ListStream(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, GSM_SMS_Entry_t* scratch, GSM_SMS_ListCallback_t callback, void* arg, uint16_t* br, uint32_t blocking) {
+    __CHECK_INPUTS(scratch && callback && br);              /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_LIST);                        /* Set active command */
+    
+    *br = 0;                                                /* Reset variable */
+    
+    Pointers.CPtr1 = SMSReadTypeString(type);               /* Save type of messages to list */
+    Pointers.Ptr1 = scratch;                                /* Save pointer to scratch entry */
+    Pointers.Ptr2 = br;                                     /* Save pointer to number of passed entries */
+    GSM->SmsListCallback = callback;                        /* Save callback, it selects streaming mode */
+    GSM->SmsListArg = arg;
+    GSM->SmsListStop = 0;
+    
+    __RETURN_BLOCKING(GSM, blocking, 10000);                /* Return with blocking possibility */
+}
+
 GSM_Result_t GSM_SMS_Delete(gvol GSM_t* GSM, uint16_t position, uint32_t blocking) {
     __CHECK_BUSY(GSM);                                      /* Check busy status */
     __ACTIVE_CMD(GSM, CMD_SMS_DELETE);                      /* Set active command */
@@ -3622,6 +5877,7 @@ GSM_Result_t GSM_SMS_MassDelete(gvol GSM_t* GSM, GSM_SMS_MassDelete_t type, uint
     __CHECK_BUSY(GSM);                                      /* Check busy status */
     __ACTIVE_CMD(GSM, CMD_SMS_MASSDELETE);                  /* Set active command */
     
+    Pointers.UI = type;                                     /* Save type */
     switch (type) {                                         /* Select MASS delete type */
         case GSM_SMS_MassDelete_Read:   Pointers.CPtr1 = FROMMEM("READ");   break;
         case GSM_SMS_MassDelete_Unread: Pointers.CPtr1 = FROMMEM("UNREAD"); break;
@@ -3655,6 +5911,199 @@ GSM_Result_t GSM_SMS_ClearReceivedInfo(gvol GSM_t* GSM, GSM_SmsInfo_t* info, uin
     info->Flags.Value = 0;                                  /* Reset all flags */
     return gsmOK;
 }
+
+GSM_Result_t GSM_SMS_QueueInit(GSM_SMS_Queue_t* queue, GSM_SMS_QueueEntry_t* entries, uint16_t size, uint8_t retries) {
+    if (queue == NULL || entries == NULL || !size) {
+        return gsmPARERROR;
+    }
+    memset(queue, 0x00, sizeof(GSM_SMS_Queue_t));           /* Reset structure */
+    queue->Entries = entries;
+    queue->Size = size;
+    queue->Retries = retries;
+    
+    return gsmOK;
+}
+
+GSM_Result_t GSM_SMS_QueueAdd(GSM_SMS_Queue_t* queue, const char* number, const char* data) {
+    GSM_SMS_QueueEntry_t* entry;
+    
+    if (queue == NULL || number == NULL || data == NULL || strlen(data) > GSM_SMS_MAX_LENGTH) {
+        return gsmPARERROR;
+    }
+    if (queue->Count >= queue->Size) {                      /* Queue is full */
+        return gsmERROR;
+    }
+    entry = &queue->Entries[queue->Count];
+    entry->Number = number;
+    entry->Data = data;
+    entry->Result = gsmBUSY;
+    entry->MemNum = 0;
+    entry->Tries = 0;
+    queue->Count++;                                         /* Entry is ready to be sent */
+    
+    return gsmOK;
+}
+
+GSM_Result_t GSM_SMS_QueueSend(gvol GSM_t* GSM, GSM_SMS_Queue_t* queue, uint32_t blocking) {
+    __CHECK_INPUTS(queue && queue->Entries);                /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    if (GSM->SMS.Queue != NULL) {                           /* Previous queue not reported yet */
+        __RETURN(GSM, gsmBUSY);
+    }
+    __ACTIVE_CMD(GSM, CMD_SMS_QUEUE);                       /* Set active command */
+    
+    queue->Sent = 0;
+    queue->Failed = 0;
+    queue->Retried = 0;
+    queue->MessagesPerMinute = 0;
+    queue->StartTime = GSM->Time;
+    GSM->SMS.QueueDone = queue->Head >= queue->Count;       /* Nothing to send */
+    GSM->SMS.Queue = queue;
+    
+    __RETURN_BLOCKING(GSM, blocking, 30000);                /* Return with blocking possibility */
+}
+
+#if GSM_SMS_PDU
+GSM_Result_t GSM_SMS_SendLong(gvol GSM_t* GSM, const char* number, const char* data, uint32_t blocking) {
+    GSM_PDU_DCS_t dcs;
+    uint8_t parts = 0;
+    
+    if (data) {
+        parts = GSM_PDU_CountParts(data, &dcs);             /* Get number of parts and alphabet */
+    }
+    __CHECK_INPUTS(number && parts);                        /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_SEND_PDU);                    /* Set active command */
+    
+    GSM->SMS.Number = number;
+    GSM->SMS.Data = data;
+    GSM->SMS.Parts = parts;
+    GSM->SMS.DCS = dcs;
+    GSM->SMS.Ref++;                                         /* New reference for concatenated message */
+    
+    __RETURN_BLOCKING(GSM, blocking, 30000);                /* Return with blocking possibility */
+}
+
+GSM_Result_t GSM_SMS_ReadPDU(gvol GSM_t* GSM, uint16_t position, char* buff, uint16_t size, GSM_PDU_t* pdu, uint32_t blocking) {
+    __CHECK_INPUTS(buff && size > 1 && pdu);                /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_READ_PDU);                    /* Set active command */
+    
+    GSM->SMS.Position = position;                           /* Save position for SMS */
+    Pointers.Ptr1 = buff;                                   /* Save pointer to PDU buffer */
+    Pointers.Ptr2 = pdu;                                    /* Save pointer to decoded message */
+    Pointers.UI = size;                                     /* Save buffer size */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking possibility */
+}
+#endif /* GSM_SMS_PDU */
+
+#if GSM_SMS_CMTI_QUEUE
+GSM_Result_t GSM_SMS_ArrivalGet(gvol GSM_t* GSM, GSM_SmsInfo_t* info) {
+    gvol GSM_SMS_Arrivals_t* q = &GSM->SmsArrivals;
+    
+    if (info == NULL) {
+        return gsmPARERROR;
+    }
+    if (q->In == q->Out) {                                  /* Check if any notification */
+        return gsmERROR;
+    }
+    memset(info, 0x00, sizeof(GSM_SmsInfo_t));
+    info->Memory = q->Entries[q->Out % GSM_SMS_CMTI_QUEUE].Memory;
+    info->Position = q->Entries[q->Out % GSM_SMS_CMTI_QUEUE].Position;
+    q->Out++;                                               /* Free oldest entry */
+    return gsmOK;
+}
+
+GSM_Result_t GSM_SMS_ArrivalReconcile(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_RECONCILE);                   /* Set active command */
+    
+    GSM->SmsArrivals.Reconcile = 0;                         /* Set again on new overflow or on error */
+    
+    __RETURN_BLOCKING(GSM, blocking, 30000);                /* Return with blocking possibility, listing takes time on full SIM */
+}
+#endif /* GSM_SMS_CMTI_QUEUE */
+
+#if GSM_SMS_INDEX
+GSM_Result_t GSM_SMS_IndexSync(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_INDEX);                       /* Set active command */
+    
+    __RETURN_BLOCKING(GSM, blocking, 30000);                /* Return with blocking possibility, listing takes time on full SIM */
+}
+
+GSM_Result_t GSM_SMS_IndexFind(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, uint16_t* positions, uint16_t btr, uint16_t* br) {
+    uint16_t i;
+    uint8_t s;
+    
+    if (positions == NULL || br == NULL) {
+        return gsmPARERROR;
+    }
+    *br = 0;
+    if (!GSM->SmsIndex.Valid) {                             /* Index must be built first */
+        return gsmERROR;
+    }
+    for (i = 0; i < GSM->SmsIndex.Total && *br < btr; i++) {
+        s = GSM->SmsIndex.Status[i];
+        if ((type == GSM_SMS_ReadType_ALL && s != SMS_INDEX_FREE) ||
+            (type == GSM_SMS_ReadType_READ && s == SMS_INDEX_READ) ||
+            (type == GSM_SMS_ReadType_UNREAD && s == SMS_INDEX_UNREAD) ||
+            (type == GSM_SMS_ReadType_SENT && s == SMS_INDEX_SENT) ||
+            (type == GSM_SMS_ReadType_UNSENT && s == SMS_INDEX_UNSENT)) {
+            positions[(*br)++] = i + 1;                     /* Save position */
+        }
+    }
+    return gsmOK;
+}
+#endif /* GSM_SMS_INDEX */
+
+#if GSM_SMS_DIRECT
+GSM_Result_t GSM_SMS_DirectInit(GSM_SMS_Direct_t* direct, GSM_SMS_Entry_t* entries, uint16_t size, uint8_t ack) {
+    if (direct == NULL || entries == NULL || !size) {
+        return gsmPARERROR;
+    }
+    memset(direct, 0x00, sizeof(GSM_SMS_Direct_t));         /* Reset structure */
+    direct->Entries = entries;
+    direct->Size = size;
+    direct->Ack = ack;
+    
+    return gsmOK;
+}
+
+GSM_Result_t GSM_SMS_DirectEnable(gvol GSM_t* GSM, GSM_SMS_Direct_t* direct, uint32_t blocking) {
+    __CHECK_INPUTS(direct == NULL || direct->Entries);      /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_SMS_DIRECT);                      /* Set active command */
+    
+    Pointers.Ptr1 = direct;                                 /* Save pointer to ring buffer */
+    Pointers.Ptr2 = GSM->SmsDirect;                         /* Restored when setup fails */
+    if (direct != NULL) {
+        GSM->SmsDirect = direct;                            /* Messages may arrive before command finishes */
+    }
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking possibility */
+}
+
+GSM_SMS_Entry_t* GSM_SMS_DirectGet(gvol GSM_t* GSM) {
+    gvol GSM_SMS_Direct_t* direct = GSM->SmsDirect;
+    
+    if (direct == NULL || direct->In == direct->Out) {      /* Check if any message */
+        return NULL;
+    }
+    return &direct->Entries[direct->Out % direct->Size];    /* Get oldest message */
+}
+
+GSM_Result_t GSM_SMS_DirectRelease(gvol GSM_t* GSM) {
+    gvol GSM_SMS_Direct_t* direct = GSM->SmsDirect;
+    
+    if (direct == NULL || direct->In == direct->Out) {
+        return gsmERROR;
+    }
+    direct->Out++;                                          /* Free oldest entry */
+    return gsmOK;
+}
+#endif /* GSM_SMS_DIRECT */
 #endif /* GSM_SMS */
 
 #if GSM_PHONEBOOK
@@ -3772,6 +6221,13 @@ GSM_Result_t GSM_GPRS_Detach(gvol GSM_t* GSM, uint32_t blocking) {
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
 }
 
+GSM_Result_t GSM_GPRS_BearerOpen(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_BEARER);                     /* Set active command */
+    
+    __RETURN_BLOCKING(GSM, blocking, 85000);                /* Return with blocking support */
+}
+
 GSM_Result_t GSM_GPRS_GetLocationAndTime(gvol GSM_t* GSM, GSM_GPS_t* GPS, uint32_t blocking) {
     __CHECK_INPUTS(GPS);                                    /* Check valid data */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
@@ -3786,8 +6242,20 @@ GSM_Result_t GSM_GPRS_GetLocationAndTime(gvol GSM_t* GSM, GSM_GPS_t* GPS, uint32
 /***                           CLIENT TCP/UDP API                            **/
 /******************************************************************************/
 GSM_Result_t GSM_CONN_Start(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, GSM_CONN_Type_t type, GSM_CONN_SSL_t ssl, const char* host, uint16_t port, uint32_t blocking) {
+    uint8_t i = 0;
+    
     __CHECK_INPUTS(conn && host);                           /* Check valid data */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
+    if (!__IS_TRANSPARENT(GSM)) {                           /* Only connection 0 is used in transparent mode */
+        for (i = 0; i < 6; i++) {                           /* Find free connection ID */
+            if (GSM->Conns[i] == NULL || GSM->Conns[i] == conn || !GSM->Conns[i]->Flags.F.Active) {
+                break;
+            }
+        }
+        if (i == 6) {                                       /* All connections are in use */
+            __RETURN(GSM, gsmERROR);
+        }
+    }
     __ACTIVE_CMD(GSM, CMD_GPRS_CIPSTART);                   /* Set active command */
      
     Pointers.Ptr1 = conn;                                   /* Save connection pointer */
@@ -3796,9 +6264,12 @@ GSM_Result_t GSM_CONN_Start(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, GSM_CONN_Typ
     Pointers.CPtr3 = FROMMEM(type == GSM_CONN_Type_TCP && ssl ? "1" : "0");
     Pointers.UI = port;                                     /* Save port */
     
-    conn->ID = 0;                                           /* Set connection ID */
+    conn->ID = i;                                           /* Set connection ID */
+    conn->SegmentSize = GSM->ConnMaxSegmentSize;            /* Use maximal segment size by default */
+    conn->SegmentLimit = GSM->ConnMaxSegmentSize;
+    conn->SendLatency = 0;
     
-    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+    __RETURN_BLOCKING(GSM, blocking, GSM_CONN_DNS_CACHE ? 10000 : 1000);    /* Return with blocking support */
 }
 
 GSM_Result_t GSM_CONN_Send(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const void* data, uint16_t btw, uint32_t* bw, uint32_t blocking) {
@@ -3814,7 +6285,49 @@ GSM_Result_t GSM_CONN_Send(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const void* d
         *bw = 0;
     }
     
-    __RETURN_BLOCKING(GSM, blocking, 10000);              /* Return with blocking support */
+    __RETURN_BLOCKING(GSM, blocking, GSM_CONN_SEND_TIMEOUT);    /* Return with blocking support */
+}
+
+GSM_Result_t GSM_CONN_ServerStart(gvol GSM_t* GSM, uint16_t port, GSM_CONN_t* conns, uint8_t count, uint32_t blocking) {
+    __CHECK_INPUTS(port && conns && count);                 /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_CIPSERVER);                  /* Set active command */
+    
+    memset((void *)conns, 0x00, sizeof(GSM_CONN_t) * count);/* Reset all connections */
+    Pointers.Ptr1 = conns;                                  /* Save connections for accepted clients */
+    Pointers.UI = ((uint32_t)count << 16) | port;           /* Save number of connections and port */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+
+GSM_Result_t GSM_CONN_ServerStop(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_CIPSERVER);                  /* Set active command */
+    
+    Pointers.UI = 0;                                        /* Stop server */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+
+GSM_Result_t GSM_CONN_SendDatagrams(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const GSM_CONN_Datagram_t* dgrams, uint16_t count, uint16_t* sent, uint32_t blocking) {
+    uint16_t i;
+    
+    __CHECK_INPUTS(conn && dgrams && count);                /* Check valid data */
+    for (i = 0; i < count; i++) {                           /* Check all datagrams */
+        __CHECK_INPUTS(dgrams[i].Data && dgrams[i].Length && dgrams[i].Length <= CONN_SEGMENT_SIZE(GSM, conn));
+    }
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_CIPSEND_DGRAM);              /* Set active command */
+    
+    Pointers.Ptr1 = conn;                                   /* Save connection pointer */
+    Pointers.Ptr2 = sent;                                   /* Pointer to number of sent datagrams */
+    Pointers.CPtr1 = dgrams;                                /* Save datagrams pointer */
+    Pointers.UI = count;                                    /* Save number of datagrams */
+    if (sent) {
+        *sent = 0;
+    }
+    
+    __RETURN_BLOCKING(GSM, blocking, GSM_CONN_SEND_TIMEOUT);    /* Return with blocking support */
 }
 
 GSM_Result_t GSM_CONN_Receive(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint32_t* br, uint16_t timeBeforeRead, uint32_t blocking) {
@@ -3829,6 +6342,27 @@ GSM_Result_t GSM_CONN_Receive(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data
     
     Pointers.Ptr1 = conn;                                   /* Save connection pointer */
     Pointers.Ptr2 = br;                                     /* Save read pointer */
+    Pointers.UI = 0;                                        /* Read requested number of bytes */
+    if (br != NULL) {                                       /* Reset counter */
+        *br = 0;
+    }
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+
+GSM_Result_t GSM_CONN_ReceiveAvailable(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint32_t* br, uint32_t blocking) {
+    __CHECK_INPUTS(conn && data && btr);                    /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_CIPRXGET);                   /* Set active command */
+    
+    conn->ReceiveData = data;                               /* Save pointer to data */
+    conn->BytesToRead = btr;
+    conn->BytesRead = 0;
+    conn->ReadTimeout = 0;                                  /* Read immediately */
+    
+    Pointers.Ptr1 = conn;                                   /* Save connection pointer */
+    Pointers.Ptr2 = br;                                     /* Save read pointer */
+    Pointers.UI = 1;                                        /* Read only waiting bytes */
     if (br != NULL) {                                       /* Reset counter */
         *br = 0;
     }
@@ -3836,29 +6370,314 @@ GSM_Result_t GSM_CONN_Receive(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
 }
 
+#if GSM_CONN_RX_DGRAM
+GSM_Result_t GSM_CONN_SetReceiveBuffer(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* buff, uint16_t size) {
+    __CHECK_INPUTS(conn && (buff == NULL || size > 2));     /* Check valid data */
+    
+    conn->RxBuff = buff;                                    /* Set receive buffer */
+    conn->RxSize = size;
+    conn->RxIn = conn->RxOut = 0;
+    conn->RxDropped = 0;
+    
+    __RETURN(GSM, gsmOK);
+}
+
+GSM_Result_t GSM_CONN_ReceiveDatagram(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint16_t* br) {
+    uint16_t len, i;
+    
+    __CHECK_INPUTS(conn && data && btr && br);              /* Check valid data */
+    
+    *br = 0;
+    if (conn->RxBuff == NULL || conn->RxIn == conn->RxOut) {/* Check if any datagram */
+        __RETURN(GSM, gsmERROR);
+    }
+    len = conn->RxBuff[conn->RxOut % conn->RxSize] | (conn->RxBuff[(conn->RxOut + 1) % conn->RxSize] << 8);
+    for (i = 0; i < len && i < btr; i++) {                  /* Copy datagram, truncate it when longer than array */
+        ((uint8_t *)data)[i] = conn->RxBuff[(conn->RxOut + 2 + i) % conn->RxSize];
+    }
+    *br = i;
+    conn->RxOut += 2 + len;                                 /* Free complete datagram */
+    conn->Flags.F.RxGetReceived = conn->RxIn != conn->RxOut;
+    
+    __RETURN(GSM, gsmOK);
+}
+#endif /* GSM_CONN_RX_DGRAM */
+
 GSM_Result_t GSM_CONN_Close(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint32_t blocking) {
     __CHECK_INPUTS(conn);                                   /* Check valid data */
-    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    WaitInternal(GSM);                                      /* Wait for internal command to finish */
+    if (__IS_BUSY(GSM)) {                                   /* Check busy status, connection can be closed in data mode */
+        __RETURN(GSM, gsmBUSY);
+    }
     __ACTIVE_CMD(GSM, CMD_GPRS_CIPCLOSE);                   /* Set active command */
      
     Pointers.Ptr1 = conn;                                   /* Save connection pointer */
     
-    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+    __RETURN_BLOCKING(GSM, blocking, __IS_TRANSPARENT_DATA(GSM) ? 3000 : 1000); /* Return with blocking support */
 }
 
 uint32_t GSM_CONN_DataAvailable(gvol GSM_t* GSM, const gvol GSM_CONN_t* conn, uint32_t blocking) {
     if (conn == NULL) {                                     /* Check valid connection */
         return 0;
     }
+#if GSM_CONN_RX_DGRAM
+    if (conn->RxIn != conn->RxOut) {                        /* Data waiting in receive buffer */
+        return 1;
+    }
+#endif /* GSM_CONN_RX_DGRAM */
     return conn->BytesRemaining || conn->Flags.F.RxGetReceived; /* At least one should be more than zero */
 }
 
+uint32_t GSM_CONN_Poll(gvol GSM_t* GSM, GSM_CONN_Poll_t* fds, uint16_t count, uint32_t timeout) {
+    volatile uint32_t start = GSM->Time;
+    uint32_t ready;
+    uint16_t i;
+    
+    if (fds == NULL) {                                      /* Check valid data */
+        return 0;
+    }
+    do {
+        ready = 0;
+        for (i = 0; i < count; i++) {                       /* Check all connections */
+            GSM_CONN_t* conn = fds[i].Conn;
+            fds[i].REvents = 0;
+            if (conn == NULL) {
+                continue;
+            }
+            if (conn->BytesRemaining || conn->Flags.F.RxGetReceived) {
+                fds[i].REvents |= GSM_CONN_PollEvent_Readable;  /* Data available to read */
+            }
+#if GSM_CONN_RX_DGRAM
+            if (conn->RxIn != conn->RxOut) {
+                fds[i].REvents |= GSM_CONN_PollEvent_Readable;  /* Data waiting in receive buffer */
+            }
+#endif /* GSM_CONN_RX_DGRAM */
+            if (conn->Flags.F.Active && __IS_READY(GSM)) {
+                fds[i].REvents |= GSM_CONN_PollEvent_Writable;  /* We can send data */
+            }
+            if (!conn->Flags.F.Active) {
+                fds[i].REvents |= conn->Flags.F.Opened ? GSM_CONN_PollEvent_Closed : GSM_CONN_PollEvent_Idle;
+            }
+            if (conn->Flags.F.SendError) {
+                fds[i].REvents |= GSM_CONN_PollEvent_Error; /* Last send failed */
+            }
+            fds[i].REvents &= fds[i].Events;                /* Report only requested events */
+            if (fds[i].REvents & GSM_CONN_PollEvent_Error) {
+                conn->Flags.F.SendError = 0;                /* Error is reported only once */
+            }
+            if (fds[i].REvents) {
+                ready++;
+            }
+        }
+        if (ready) {                                        /* Anything ready? */
+            break;
+        }
+#if !GSM_RTOS && !GSM_ASYNC
+        GSM_Update(GSM);                                    /* Process incoming data */
+#endif
+    } while (GSM->Time - start < timeout);
+    return ready;
+}
+
+GSM_Result_t GSM_CONN_SetSegmentSize(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint16_t size) {
+    __CHECK_INPUTS(conn && size);                           /* Check valid data */
+    
+    if (size > GSM->ConnMaxSegmentSize) {                   /* Check maximal value */
+        size = GSM->ConnMaxSegmentSize;
+    }
+    conn->SegmentSize = size;                               /* Set new segment size */
+    conn->SegmentLimit = size;                              /* Automatic tuning does not go above user value */
+    
+    __RETURN(GSM, gsmOK);
+}
+
+#if GSM_CONN_TRANSPARENT
+GSM_Result_t GSM_CONN_SetTransparent(gvol GSM_t* GSM, uint8_t enable) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    
+    GSM->Flags.F.Transparent = !!enable;                    /* Set mode for next attach */
+    
+    __RETURN(GSM, gsmOK);
+}
+
+GSM_Result_t GSM_CONN_TransparentSend(gvol GSM_t* GSM, const void* data, uint16_t btw) {
+    __CHECK_INPUTS(data && btw);                            /* Check valid data */
+    if (!__IS_TRANSPARENT_DATA(GSM)) {                      /* We must be in data mode */
+        __RETURN(GSM, gsmERROR);
+    }
+    
+    UART_SEND(data, btw);                                   /* Send raw data */
+    
+    __RETURN(GSM, Send.Result ? gsmLLERROR : gsmOK);
+}
+
+uint32_t GSM_CONN_TransparentReceive(gvol GSM_t* GSM, void* data, uint32_t btr) {
+    uint32_t br;
+    
+    if (data == NULL || !__IS_TRANSPARENT_DATA(GSM)) {      /* Check valid data and mode */
+        return 0;
+    }
+    if (GSM->TransparentClosed && btr > GSM->TransparentLeft) { /* Do not read remote close notification */
+        btr = GSM->TransparentLeft;
+    } else if (!GSM->TransparentClosed && GSM->TransparentMatch) {  /* Keep possible notification until it is confirmed */
+        br = (GSM->TransparentMatchStart + Buffer.Size - Buffer.Out) % Buffer.Size;
+        if (btr > br) {
+            btr = br;
+        }
+    }
+    br = BUFFER_Read(&Buffer, data, btr);                   /* Read raw data directly from receive buffer */
+    if (GSM->TransparentClosed) {
+        GSM->TransparentLeft -= br;
+    }
+    return br;
+}
+
+GSM_Result_t GSM_CONN_TransparentExit(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_INPUTS(__IS_TRANSPARENT_DATA(GSM));             /* We must be in data mode */
+    WaitInternal(GSM);                                      /* Wait for internal command to finish */
+    if (__IS_BUSY(GSM)) {                                   /* Check busy status */
+        __RETURN(GSM, gsmBUSY);
+    }
+    __ACTIVE_CMD(GSM, CMD_GPRS_TRANSPARENT_EXIT);           /* Set active command */
+    
+    __RETURN_BLOCKING(GSM, blocking, 3000);                 /* Return with blocking support */
+}
+
+GSM_Result_t GSM_CONN_TransparentResume(gvol GSM_t* GSM, uint32_t blocking) {
+    __CHECK_INPUTS(__IS_TRANSPARENT(GSM));                  /* Transparent mode must be selected */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_TRANSPARENT_RESUME);         /* Set active command */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+#endif /* GSM_CONN_TRANSPARENT */
+
+#if GSM_CONN_QSEND
+GSM_Result_t GSM_CONN_GetAck(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint32_t* acked, uint32_t blocking) {
+    __CHECK_INPUTS(conn);                                   /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_CIPACK);                     /* Set active command */
+    
+    Pointers.Ptr1 = conn;                                   /* Save connection pointer */
+    Pointers.Ptr2 = acked;                                  /* Save pointer for acknowledged bytes */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+#endif /* GSM_CONN_QSEND */
+
+#if GSM_CONN_POOL
+GSM_Result_t GSM_CONN_PoolGet(gvol GSM_t* GSM, GSM_CONN_t** conn, GSM_CONN_Type_t type, GSM_CONN_SSL_t ssl, const char* host, uint16_t port, uint32_t blocking) {
+    GSM_CONN_PoolEntry_t* entry = NULL;
+    GSM_CONN_PoolEntry_t* e;
+    GSM_Result_t res;
+    uint8_t i;
+    
+    __CHECK_INPUTS(conn && host && strlen(host) < GSM_CONN_POOL_HOST_LENGTH);   /* Check valid data */
+    *conn = NULL;                                           /* Set only when connection is established */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    
+    for (i = 0; i < GSM_CONN_POOL; i++) {                   /* Try to find alive connection with the same parameters */
+        e = (GSM_CONN_PoolEntry_t *)&GSM->ConnPool[i];
+        if (!e->InUse && e->Conn.Flags.F.Active && e->Port == port && e->Type == (uint8_t)type && e->SSL == (uint8_t)ssl && strcmp(e->Host, host) == 0) {
+            e->InUse = 1;                                   /* Connection is in use now */
+            *conn = &e->Conn;                               /* Reuse established connection */
+            __RETURN(GSM, gsmOK);
+        }
+    }
+    for (i = 0; i < GSM_CONN_POOL; i++) {                   /* Find free entry */
+        e = (GSM_CONN_PoolEntry_t *)&GSM->ConnPool[i];
+        if (!e->InUse && !e->Conn.Flags.F.Active) {
+            entry = e;
+            break;
+        }
+    }
+    if (entry == NULL) {                                    /* No free entry, find least recently used idle connection */
+        for (i = 0; i < GSM_CONN_POOL; i++) {
+            e = (GSM_CONN_PoolEntry_t *)&GSM->ConnPool[i];
+            if (!e->InUse && (entry == NULL || (GSM->Time - e->LastUsed) > (GSM->Time - entry->LastUsed))) {
+                entry = e;
+            }
+        }
+        if (entry == NULL) {                                /* All connections are in use */
+            __RETURN(GSM, gsmERROR);
+        }
+        if ((res = GSM_CONN_Close(GSM, &entry->Conn, blocking)) != gsmOK) { /* Close idle connection first */
+            return res;
+        }
+        if (!blocking) {                                    /* Close is in progress, entry is free when stack is idle */
+            __RETURN(GSM, gsmBUSY);
+        }
+    }
+    
+    memset((void *)entry, 0x00, sizeof(GSM_CONN_PoolEntry_t));  /* Reset entry */
+    strcpy(entry->Host, host);                              /* Save connection parameters */
+    entry->Port = port;
+    entry->Type = (uint8_t)type;
+    entry->SSL = (uint8_t)ssl;
+    entry->InUse = 1;
+    GSM->ConnPoolStart = entry;                             /* Connection is saved to user when connected */
+    GSM->ConnPoolOut = conn;
+    
+    res = GSM_CONN_Start(GSM, &entry->Conn, type, ssl, entry->Host, port, blocking);    /* Start new connection */
+    if (res != gsmOK && GSM->ConnPoolStart == entry) {      /* Command was not started at all */
+        entry->InUse = 0;                                   /* Entry is free again */
+        GSM->ConnPoolStart = NULL;
+        GSM->ConnPoolOut = NULL;
+    }
+    return res;
+}
+
+GSM_Result_t GSM_CONN_PoolRelease(gvol GSM_t* GSM, GSM_CONN_t* conn) {
+    uint8_t i;
+    
+    for (i = 0; i < GSM_CONN_POOL; i++) {
+        if (&GSM->ConnPool[i].Conn == conn) {               /* Connection is part of pool */
+            GSM->ConnPool[i].InUse = 0;                     /* Connection is not in use anymore */
+            GSM->ConnPool[i].LastUsed = GSM->Time;          /* Save time for idle timeout */
+            __RETURN(GSM, gsmOK);
+        }
+    }
+    __RETURN(GSM, gsmPARERROR);
+}
+
+GSM_Result_t GSM_CONN_PoolUpdate(gvol GSM_t* GSM, uint32_t blocking) {
+#if GSM_CONN_POOL_IDLE_TIMEOUT
+    uint8_t i;
+    
+    for (i = 0; i < GSM_CONN_POOL; i++) {                   /* Close first expired idle connection */
+        GSM_CONN_PoolEntry_t* e = (GSM_CONN_PoolEntry_t *)&GSM->ConnPool[i];
+        if (!e->InUse && e->Conn.Flags.F.Active && (GSM->Time - e->LastUsed) >= GSM_CONN_POOL_IDLE_TIMEOUT) {
+            return GSM_CONN_Close(GSM, &e->Conn, blocking);
+        }
+    }
+#endif /* GSM_CONN_POOL_IDLE_TIMEOUT */
+    __RETURN(GSM, gsmOK);
+}
+#endif /* GSM_CONN_POOL */
+
+#if GSM_CONN_DNS_CACHE
+GSM_Result_t GSM_CONN_DNSCacheFlush(gvol GSM_t* GSM) {
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    
+    memset((void *)GSM->DNSCache, 0x00, sizeof(GSM->DNSCache)); /* Remove all entries */
+    GSM->DNSCacheHits = 0;                                  /* Reset counters */
+    GSM->DNSCacheMisses = 0;
+    
+    __RETURN(GSM, gsmOK);
+}
+#endif /* GSM_CONN_DNS_CACHE */
+
 #if GSM_HTTP
 /******************************************************************************/
 /***                                 HTTP API                                **/
 /******************************************************************************/
 GSM_Result_t GSM_HTTP_Begin(gvol GSM_t* GSM, uint32_t blocking) {
     __CHECK_BUSY(GSM);                                      /* Check busy status */
+#if GSM_HTTP_SESSION
+    if (GSM->HTTP.SessionActive) {                          /* HTTP is already initialized */
+        __RETURN(GSM, gsmOK);
+    }
+#endif /* GSM_HTTP_SESSION */
     __ACTIVE_CMD(GSM, CMD_GPRS_HTTPBEGIN);                  /* Set active command */
     
     memset((void *)&GSM->HTTP, 0x00, sizeof(GSM->HTTP));    /* Set structure to zero */
@@ -3874,7 +6693,7 @@ GSM_Result_t GSM_HTTP_End(gvol GSM_t* GSM, uint32_t blocking) {
 }
 
 GSM_Result_t GSM_HTTP_SetData(gvol GSM_t* GSM, const void* data, uint32_t btw, uint32_t blocking) {
-    __CHECK_INPUTS(data && btw);                            /* Check valid data */
+    __CHECK_INPUTS(data && btw && btw <= HTTP_DATA_SIZE_MAX);   /* Check valid data */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
     __ACTIVE_CMD(GSM, CMD_GPRS_HTTPSEND);                   /* Set active command */
     
@@ -3884,6 +6703,19 @@ GSM_Result_t GSM_HTTP_SetData(gvol GSM_t* GSM, const void* data, uint32_t btw, u
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
 }
 
+GSM_Result_t GSM_HTTP_SetDataStream(gvol GSM_t* GSM, uint32_t btw, void* buff, uint32_t size, GSM_HTTP_Producer_t producer, uint32_t blocking) {
+    __CHECK_INPUTS(btw && btw <= HTTP_DATA_SIZE_MAX && buff && size && producer);   /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_HTTPSEND_STREAM);            /* Set active command */
+    
+    GSM->HTTP.Data = buff;                                  /* Save chunk buffer */
+    GSM->HTTP.DataLength = size;
+    GSM->HTTP.Producer = producer;                          /* Save producer function */
+    Pointers.UI = btw;                                      /* Save total length */
+    
+    __RETURN_BLOCKING(GSM, blocking, 10000);                /* Return with blocking support */
+}
+
 GSM_Result_t GSM_HTTP_SetContent(gvol GSM_t* GSM, const char* content, uint32_t blocking) {
     __CHECK_INPUTS(content);                                /* Check valid data */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
@@ -3900,15 +6732,24 @@ GSM_Result_t GSM_HTTP_Execute(gvol GSM_t* GSM, const char* url, GSM_HTTP_Method_
     __ACTIVE_CMD(GSM, CMD_GPRS_HTTPEXECUTE);                /* Set active command */
     
     /* Reset informations */
+    GSM->HTTP.Code = 0;
     GSM->HTTP.BytesRead = 0;
     GSM->HTTP.BytesReadRemaining = 0;
     GSM->HTTP.BytesReadTotal = 0;
     GSM->HTTP.BytesReceived = 0;
     GSM->HTTP.BytesToRead = 0;
+    GSM->HTTP.BodyOffset = 0;
     
     GSM->HTTP.TMP = url;                                    /* Save URL */
     GSM->HTTP.Method = method;                              /* Set request method */
     Pointers.CPtr1 = FROMMEM(ssl ? "1" : "0");
+    Pointers.UI = 0x03;                                     /* Send URL and SSL */
+#if GSM_HTTP_SESSION
+    if (GSM->HTTP.ParamsValid && GSM->HTTP.SSL == (uint8_t)ssl) {   /* Skip SSL when already set on module */
+        Pointers.UI &= ~0x02;
+    }
+    GSM->HTTP.SSL = (uint8_t)ssl;                           /* Save new SSL setting */
+#endif /* GSM_HTTP_SESSION */
     
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
 }
@@ -3932,6 +6773,89 @@ GSM_Result_t GSM_HTTP_Read(gvol GSM_t* GSM, void* data, uint32_t btr, uint32_t*
 uint32_t GSM_HTTP_DataAvailable(gvol GSM_t* GSM, uint32_t blocking) {
     return GSM->HTTP.BytesReceived - GSM->HTTP.BytesReadTotal;
 }
+
+GSM_Result_t GSM_HTTP_SetUserData(gvol GSM_t* GSM, const char* data, uint32_t blocking) {
+    __CHECK_INPUTS(data);                                   /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_HTTPUSERDATA);               /* Set active command */
+    
+    GSM->HTTP.TMP = data;                                   /* Save header pointer */
+    
+    __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
+}
+
+GSM_Result_t GSM_HTTP_DownloadInit(GSM_HTTP_Download_t* dl, const char* url, GSM_HTTP_SSL_t ssl) {
+    if (dl == NULL || url == NULL) {
+        return gsmPARERROR;
+    }
+    memset(dl, 0x00, sizeof(GSM_HTTP_Download_t));         /* Reset structure */
+    dl->URL = url;
+    dl->SSL = ssl;
+    
+    return gsmOK;
+}
+
+GSM_Result_t GSM_HTTP_DownloadRun(gvol GSM_t* GSM, GSM_HTTP_Download_t* dl, void* buff, uint32_t size, GSM_HTTP_Sink_t sink) {
+    char range[32];
+    GSM_Result_t res;
+    uint8_t tries = 0;
+    
+    __CHECK_INPUTS(dl && dl->URL && buff && size && sink);  /* Check valid data */
+    if (dl->Completed) {                                    /* Nothing to do */
+        __RETURN(GSM, gsmOK);
+    }
+    
+    strcpy(range, "Range: bytes=");                         /* Create range header */
+    NumberToString(&range[strlen(range)], dl->Offset);
+    strcat(range, "-");
+    while (1) {
+        if (dl->Offset) {                                   /* Request only missing part */
+            if ((res = GSM_HTTP_SetUserData(GSM, range, 1)) != gsmOK) {
+                return res;
+            }
+        }
+        res = GSM_HTTP_Execute(GSM, dl->URL, GSM_HTTP_Method_GET, dl->SSL, 1);
+        if (dl->Offset) {
+            GSM_HTTP_SetUserData(GSM, "", 1);               /* Remove range header for next requests */
+        }
+        if (res == gsmOK || GSM->HTTP.Code != 601 || tries++) { /* Repeat once on network error, user data is set again */
+            break;
+        }
+    }
+    if (res != gsmOK) {
+        return res;
+    }
+    
+    if (GSM->HTTP.Code == 206) {                            /* Partial content, body starts at requested offset */
+        GSM->HTTP.BodyOffset = dl->Offset;
+    } else if (GSM->HTTP.Code == 200) {                     /* Complete resource, skip already downloaded part */
+        if (dl->Offset > GSM->HTTP.BytesReceived) {
+            __RETURN(GSM, gsmERROR);
+        }
+        GSM->HTTP.BytesReadTotal = dl->Offset;
+    } else {
+        __RETURN(GSM, gsmERROR);
+    }
+    dl->Total = GSM->HTTP.BodyOffset + GSM->HTTP.BytesReceived;
+    
+    res = GSM_HTTP_ReadStream(GSM, buff, size, sink, 1);    /* Read data to sink */
+    dl->Offset = GSM->HTTP.BodyOffset + GSM->HTTP.BytesReadTotal;   /* Save confirmed position */
+    dl->Completed = dl->Offset == dl->Total;
+    
+    return res;
+}
+
+GSM_Result_t GSM_HTTP_ReadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_HTTP_Sink_t sink, uint32_t blocking) {
+    __CHECK_INPUTS(buff && size && sink);                   /* Check valid data */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_HTTPREAD_STREAM);            /* Set active command */
+    
+    GSM->HTTP.Data = buff;                                  /* Set chunk buffer */
+    GSM->HTTP.DataLength = size;
+    GSM->HTTP.Sink = sink;                                  /* Set sink function */
+    
+    __RETURN_BLOCKING(GSM, blocking, 10000);                /* Return with blocking support */
+}
 #endif /* GSM_HTTP */
 
 #if GSM_FTP
@@ -3975,14 +6899,20 @@ GSM_Result_t GSM_FTP_Authenticate(gvol GSM_t* GSM, const char* server, uint16_t
 }
 
 GSM_Result_t GSM_FTP_DownloadBegin(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t blocking) {
-    __CHECK_INPUTS(folder && file);                         /* Check input values */
+    return GSM_FTP_DownloadBeginAt(GSM, folder, file, 0, blocking);
+}
+
+GSM_Result_t GSM_FTP_DownloadBeginAt(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t offset, uint32_t blocking) {
+    __CHECK_INPUTS(file);                                   /* Check input values */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
     __ACTIVE_CMD(GSM, CMD_GPRS_FTPDOWNBEGIN);               /* Set active command */
     
     memset((void *)&GSM->FTP, 0x00, sizeof(GSM_FTP_t));     /* Reset structure */
+    GSM->FTP.BytesProcessedTotal = offset;                  /* Continue from offset */
     
     Pointers.CPtr1 = folder;                                /* Save pointers */
     Pointers.CPtr2 = file;
+    Pointers.UI = offset;
     
     __RETURN_BLOCKING(GSM, blocking, 75000);                /* Return with blocking support */
 }
@@ -4017,8 +6947,43 @@ GSM_Result_t GSM_FTP_DownloadEnd(gvol GSM_t* GSM, uint32_t blocking) {
     __RETURN_BLOCKING(GSM, blocking, 60000);                /* Return with blocking support */
 }
 
+GSM_Result_t GSM_FTP_DownloadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_FTP_Sink_t sink, uint32_t blocking) {
+    __CHECK_INPUTS(buff && size && sink);                   /* Check input values */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_FTPDOWN_STREAM);             /* Set active command */
+    
+    GSM->FTP.BytesToProcess = size;
+    GSM->FTP.Data = buff;
+    GSM->FTP.Sink = sink;
+    
+    __RETURN_BLOCKING(GSM, blocking, 75000);                /* Return with blocking support */
+}
+
+GSM_Result_t GSM_FTP_DownloadResume(gvol GSM_t* GSM, const char* folder, const char* file, void* buff, uint32_t size, GSM_FTP_Sink_t sink, uint32_t* offset, uint8_t retries) {
+    GSM_Result_t res;
+    
+    __CHECK_INPUTS(file && buff && size && sink && offset); /* Check input values */
+    
+    while (1) {
+        res = GSM_FTP_DownloadBeginAt(GSM, folder, file, *offset, 1);   /* Start download from last position */
+        if (res == gsmOK) {
+            res = GSM_FTP_DownloadStream(GSM, buff, size, sink, 1); /* Read data to sink */
+            *offset = GSM->FTP.BytesProcessedTotal;         /* Save position accepted by sink */
+        }
+#if GSM_FTP_EXTGET
+        GSM_FTP_DownloadEnd(GSM, 1);                        /* Release module memory */
+#endif /* GSM_FTP_EXTGET */
+        if (res == gsmOK || GSM->FTP.Flags.F.Aborted || !retries--) {
+            break;
+        }
+        GSM_FTP_End(GSM, 1);                                /* Close broken session */
+        GSM_GPRS_BearerOpen(GSM, 1);                        /* Open bearer if it was lost */
+    }
+    return res;
+}
+
 GSM_Result_t GSM_FTP_UploadBegin(gvol GSM_t* GSM, const char* folder, const char* file, GSM_FTP_UploadMode_t mode, uint32_t blocking) {
-    __CHECK_INPUTS(folder && file);                         /* Check input values */
+    __CHECK_INPUTS(file);                                   /* Check input values */
     __CHECK_BUSY(GSM);                                      /* Check busy status */
     __ACTIVE_CMD(GSM, CMD_GPRS_FTPUPBEGIN);                 /* Set active command */
     
@@ -4056,4 +7021,113 @@ GSM_Result_t GSM_FTP_UploadEnd(gvol GSM_t* GSM, uint32_t blocking) {
     
     __RETURN_BLOCKING(GSM, blocking, 1000);                 /* Return with blocking support */
 }
+
+GSM_Result_t GSM_FTP_UploadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_FTP_Producer_t producer, uint32_t blocking) {
+    __CHECK_INPUTS(buff && size >= 2 && producer);          /* Check input values */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_FTPUP_STREAM);               /* Set active command */
+    
+    GSM->FTP.BytesToProcess = size / 2;                     /* Size of each staging buffer */
+    if (GSM->FTP.MaxBytesToPut && GSM->FTP.BytesToProcess > GSM->FTP.MaxBytesToPut) {
+        GSM->FTP.BytesToProcess = GSM->FTP.MaxBytesToPut;   /* Module does not accept more at a time */
+    }
+    GSM->FTP.Data = buff;
+    GSM->FTP.Producer = producer;
+    GSM->FTP.BytesProcessedTotal = 0;
+    GSM->FTP.BytesPerSecond = 0;
+    
+    __RETURN_BLOCKING(GSM, blocking, 75000);                /* Return with blocking support */
+}
+
+GSM_Result_t GSM_FTP_SessionRun(gvol GSM_t* GSM, GSM_FTP_Session_t* session, GSM_FTP_Transfer_t* transfers, uint16_t count) {
+    GSM_FTP_Transfer_t* t;
+    const char* folder[2] = {NULL, NULL};                   /* Last folder set for download and upload */
+    const char* f;
+    uint32_t start, time = 0;
+    GSM_Result_t res;
+    uint16_t i;
+    
+    __CHECK_INPUTS(session && session->Buff && session->Size && transfers && count);    /* Check input values */
+    
+    session->FilesDone = 0;
+    session->Bytes = 0;
+    session->BytesPerSecond = 0;
+    
+    if ((res = GSM_FTP_Begin(GSM, session->Mode, session->SSL, 1)) != gsmOK ||
+        (res = GSM_FTP_Authenticate(GSM, session->Server, session->Port, session->User, session->Pass, 1)) != gsmOK) {
+        GSM_FTP_End(GSM, 1);                                /* Close partially opened session */
+        return res;
+    }
+    
+    for (i = 0; i < count; i++) {
+        t = &transfers[i];
+        t->Bytes = 0;
+        t->BytesPerSecond = 0;
+        f = folder[t->Upload] && t->Folder && strcmp(folder[t->Upload], t->Folder) == 0 ? NULL : t->Folder; /* Set folder only when changed */
+        
+        start = GSM->Time;
+        if (t->Upload) {
+            res = t->Producer ? GSM_FTP_UploadBegin(GSM, f, t->File, t->UploadMode, 1) : gsmPARERROR;
+            t->Result = res;
+            if (res == gsmOK) {
+                t->Result = GSM_FTP_UploadStream(GSM, session->Buff, session->Size, t->Producer, 1);
+                t->Bytes = GSM->FTP.BytesProcessedTotal;
+                if (GSM_FTP_UploadEnd(GSM, 1) != gsmOK && t->Result == gsmOK) {
+                    t->Result = gsmERROR;
+                }
+            } else if (res != gsmPARERROR) {
+                GSM_FTP_UploadEnd(GSM, 1);                  /* Close upload when it was opened partially */
+            }
+        } else {
+            res = t->Sink ? GSM_FTP_DownloadBegin(GSM, f, t->File, 1) : gsmPARERROR;
+            t->Result = res;
+            if (res == gsmOK) {
+                t->Result = GSM_FTP_DownloadStream(GSM, session->Buff, session->Size, t->Sink, 1);
+                t->Bytes = GSM->FTP.BytesProcessedTotal;
+            }
+#if GSM_FTP_EXTGET
+            if (res != gsmPARERROR) {
+                GSM_FTP_DownloadEnd(GSM, 1);                /* Release module memory */
+            }
+#else
+            if (res != gsmPARERROR && t->Result != gsmOK) {
+                GSM_FTP_DownloadEnd(GSM, 1);                /* Abort unfinished download */
+            }
+#endif /* GSM_FTP_EXTGET */
+        }
+        if (res != gsmOK) {
+            folder[t->Upload] = NULL;                       /* Folder state not known, set it again on next transfer */
+        } else if (f != NULL) {
+            folder[t->Upload] = f;                          /* Module keeps folder for next transfers */
+        }
+        
+        start = GSM->Time - start;                          /* Get transfer time */
+        time += start;
+        if (start) {
+            t->BytesPerSecond = (uint32_t)((uint64_t)t->Bytes * 1000 / start);
+        }
+        if (t->Result == gsmOK) {
+            session->FilesDone++;
+        }
+        session->Bytes += t->Bytes;
+    }
+    if (time) {
+        session->BytesPerSecond = (uint32_t)((uint64_t)session->Bytes * 1000 / time);
+    }
+    
+    GSM_FTP_End(GSM, 1);                                    /* Close session once for all files */
+    return session->FilesDone == count ? gsmOK : gsmERROR;
+}
+
+GSM_Result_t GSM_FTP_GetSize(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t* size, uint32_t blocking) {
+    __CHECK_INPUTS(folder && file && size);                 /* Check input values */
+    __CHECK_BUSY(GSM);                                      /* Check busy status */
+    __ACTIVE_CMD(GSM, CMD_GPRS_FTPGETSIZE);                 /* Set active command */
+    
+    Pointers.CPtr1 = folder;                                /* Save pointers */
+    Pointers.CPtr2 = file;
+    Pointers.Ptr1 = size;
+    
+    __RETURN_BLOCKING(GSM, blocking, 75000);                /* Return with blocking support */
+}
 #endif /* GSM_FTP */
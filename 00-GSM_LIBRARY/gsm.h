@@ -76,6 +76,87 @@ extern "C" {
 #if !defined(GSM_SMS)
 #define GSM_SMS             1
 #endif
+#if !defined(GSM_CONN_QSEND)
+#define GSM_CONN_QSEND      0
+#endif
+#if !defined(GSM_CONN_QSEND_WINDOW)
+#define GSM_CONN_QSEND_WINDOW   4380
+#endif
+#if !defined(GSM_CONN_QSEND_ACK_TIMEOUT)
+#define GSM_CONN_QSEND_ACK_TIMEOUT  10000
+#endif
+#if !defined(GSM_CONN_SEND_TIMEOUT)
+#define GSM_CONN_SEND_TIMEOUT   10000
+#endif
+#if !defined(GSM_CONN_SEGMENT_AUTO)
+#define GSM_CONN_SEGMENT_AUTO   0
+#endif
+#if !defined(GSM_CONN_TRANSPARENT)
+#define GSM_CONN_TRANSPARENT    0
+#endif
+#if !defined(GSM_CONN_POOL)
+#define GSM_CONN_POOL           0
+#endif
+#if !defined(GSM_CONN_POOL_HOST_LENGTH)
+#define GSM_CONN_POOL_HOST_LENGTH   48
+#endif
+#if !defined(GSM_CONN_POOL_IDLE_TIMEOUT)
+#define GSM_CONN_POOL_IDLE_TIMEOUT  60000
+#endif
+#if !defined(GSM_CONN_DNS_CACHE)
+#define GSM_CONN_DNS_CACHE      0
+#endif
+#if !defined(GSM_CONN_DNS_CACHE_TTL)
+#define GSM_CONN_DNS_CACHE_TTL  300000
+#endif
+#if !defined(GSM_CONN_DNS_CACHE_HOST_LENGTH)
+#define GSM_CONN_DNS_CACHE_HOST_LENGTH  48
+#endif
+#if !defined(GSM_CONN_RX_LENGTH)
+#define GSM_CONN_RX_LENGTH      0
+#endif
+#if !defined(GSM_CONN_RX_DGRAM)
+#define GSM_CONN_RX_DGRAM       0
+#endif
+#if !defined(GSM_HTTP_SESSION)
+#define GSM_HTTP_SESSION        0
+#endif
+#if !defined(GSM_HTTP_STREAM_RATE)
+#define GSM_HTTP_STREAM_RATE    2000
+#endif
+#if !defined(GSM_HTTP_CLIENT)
+#define GSM_HTTP_CLIENT         0
+#endif
+#if !defined(GSM_HTTP_CLIENT_TIMEOUT)
+#define GSM_HTTP_CLIENT_TIMEOUT 30000
+#endif
+#if !defined(GSM_FTP_EXTGET)
+#define GSM_FTP_EXTGET          0
+#endif
+#if !defined(GSM_FTP_EXTGET_TIMEOUT)
+#define GSM_FTP_EXTGET_TIMEOUT  600000
+#endif
+#if !defined(GSM_SMS_PDU)
+#define GSM_SMS_PDU             0
+#endif
+#if !defined(GSM_SMS_CONCAT_PARTS)
+#define GSM_SMS_CONCAT_PARTS    4
+#endif
+#if !defined(GSM_SMS_CONCAT_TIMEOUT)
+#define GSM_SMS_CONCAT_TIMEOUT  300000
+#endif
+#if !defined(GSM_SMS_DIRECT)
+#define GSM_SMS_DIRECT          0
+#endif
+#if !defined(GSM_SMS_CMTI_QUEUE)
+#define GSM_SMS_CMTI_QUEUE      0
+#endif
+#if !defined(GSM_SMS_INDEX)
+#define GSM_SMS_INDEX           0
+#endif
+#if !defined(GSM_SMS_INDEX_SIZE)
+#define GSM_SMS_INDEX_SIZE      50
+#endif
 
 /**
  * @defgroup GSM_Macros
@@ -119,6 +200,7 @@ typedef enum _GSM_Result_t {
     gsmNETWORKNOTREGISTEREDSEARCHINERROR,                   /*!< Device is not connected to network, but is searching for network. You might wait a little time when this status is returned */
     gsmNETWORKREGISTRATIONDENIEDERROR,                      /*!< Device found network but registration to it has been denied */
     gsmNETWORKERROR,
+    gsmABORTED,                                             /*!< Operation was stopped by user callback function */
 } GSM_Result_t;
 
 /**
@@ -159,7 +241,8 @@ typedef enum _GSM_SMS_Memory_t {
     GSM_SMS_Memory_SM,
     GSM_SMS_Memory_BM,
     GSM_SMS_Memory_SE,
-    GSM_SMS_Memory_ME
+    GSM_SMS_Memory_ME,
+    GSM_SMS_Memory_MT
 } GSM_SMS_Memory_t;
 
 /**
@@ -225,6 +308,56 @@ typedef struct _GSM_DateTime_t {
     GSM_Time_t Time;                                        /*!< Time data */
 } GSM_DateTime_t;
 
+/**
+ * \brief         SMS send queue entry
+ */
+typedef struct _GSM_SMS_QueueEntry_t {
+    const char* Number;                                     /*!< Pointer to constant string for number */
+    const char* Data;                                       /*!< Pointer to constant data array */
+    GSM_Result_t Result;                                    /*!< Result of sending message */
+    uint16_t MemNum;                                        /*!< Message reference returned by network on success */
+    uint8_t Tries;                                          /*!< Number of retries used for message */
+} GSM_SMS_QueueEntry_t;
+
+/**
+ * \brief         SMS send queue
+ */
+typedef struct _GSM_SMS_Queue_t {
+    GSM_SMS_QueueEntry_t* Entries;                          /*!< Pointer to array of entries */
+    uint16_t Size;                                          /*!< Number of entries in array */
+    uint16_t Count;                                         /*!< Number of entries added to queue */
+    uint16_t Head;                                          /*!< Index of next entry to send */
+    uint16_t Notified;                                      /*!< Index of next entry to report to user */
+    uint8_t Retries;                                        /*!< Number of retries for each message on error */
+    uint16_t Sent;                                          /*!< Number of messages sent successfully */
+    uint16_t Failed;                                        /*!< Number of messages not sent after all retries */
+    uint16_t Retried;                                       /*!< Total number of retries */
+    uint32_t StartTime;                                     /*!< Time when sending started */
+    uint32_t MessagesPerMinute;                             /*!< Average throughput in units of messages per minute */
+} GSM_SMS_Queue_t;
+
+/**
+ * \brief         Data coding scheme for SMS in PDU mode
+ */
+typedef enum _GSM_PDU_DCS_t {
+    GSM_PDU_DCS_GSM7 = 0x00,                                /*!< GSM 7-bit default alphabet */
+    GSM_PDU_DCS_8BIT = 0x04,                                /*!< 8-bit binary data */
+    GSM_PDU_DCS_UCS2 = 0x08                                 /*!< UCS2 (UTF-16 big endian) data */
+} GSM_PDU_DCS_t;
+
+/**
+ * \brief         Received SMS decoded from PDU
+ */
+typedef struct _GSM_PDU_t {
+    char Number[20];                                        /*!< Sender phone number or alphanumeric name */
+    GSM_PDU_DCS_t DCS;                                      /*!< Data coding scheme of user data */
+    uint16_t Ref;                                           /*!< Reference number of concatenated message */
+    uint8_t Parts;                                          /*!< Number of parts of concatenated message, 1 for single message */
+    uint8_t Part;                                           /*!< Index of this part, starting with 1 */
+    const uint8_t* Data;                                    /*!< Pointer to user data without header. GSM 7-bit data are unpacked to 1 septet per byte */
+    uint8_t Length;                                         /*!< Length of user data in units of bytes */
+} GSM_PDU_t;
+
 /**
  * \brief         SMS structure for send message
  */
@@ -232,6 +365,14 @@ typedef struct _GSM_SMS_t {
     const char* Number;                                     /*!< Pointer to constant string for number */
     const char* Data;                                       /*!< Pointer to constant data array */
     uint16_t SentSMSMemNum;                                 /*!< Memory number for sent SMS */
+    GSM_SMS_Queue_t* Queue;                                 /*!< Pointer to active send queue, released after last entry is reported */
+    uint8_t QueueDone;                                      /*!< Set to 1 when all entries of queue were processed */
+    uint8_t Ref;                                            /*!< Reference number for next concatenated message */
+    uint8_t Part;                                           /*!< Index of part currently sent */
+    uint8_t Parts;                                          /*!< Number of parts of message currently sent */
+    uint8_t DCS;                                            /*!< Data coding scheme of message currently sent */
+    uint16_t Position;                                      /*!< Position of message to read in PDU mode */
+    uint16_t ReadLen;                                       /*!< Number of PDU characters received */
 } GSM_SMS_t;
 
 /**
@@ -267,6 +408,32 @@ typedef struct _GSM_SmsInfo_t {
     } Flags;                                                /*!< Structure flags management */
 } GSM_SmsInfo_t;
 
+#if GSM_SMS_CMTI_QUEUE
+/**
+ * \brief         Queue of received SMS notifications
+ */
+typedef struct _GSM_SMS_Arrivals_t {
+    GSM_SmsInfo_t Entries[GSM_SMS_CMTI_QUEUE];              /*!< Received notifications, only memory and position are used */
+    uint32_t In;                                            /*!< Number of added notifications, free running */
+    uint32_t Out;                                           /*!< Number of notifications read by user, free running */
+    uint16_t Overflow;                                      /*!< Number of notifications which did not fit into queue */
+    uint8_t Reconcile;                                      /*!< Set to 1 after overflow, call \ref GSM_SMS_ArrivalReconcile to find lost notifications */
+    GSM_SMS_Memory_t Memory;                                /*!< Memory of last received notification */
+} GSM_SMS_Arrivals_t;
+#endif /* GSM_SMS_CMTI_QUEUE */
+
+#if GSM_SMS_INDEX
+/**
+ * \brief         Index of message storage
+ */
+typedef struct _GSM_SMS_Index_t {
+    uint8_t Status[GSM_SMS_INDEX_SIZE];                     /*!< Status of each position, starting with position 1 */
+    uint16_t Total;                                         /*!< Number of positions in message storage */
+    GSM_SMS_Memory_t Memory;                                /*!< Indexed message storage, where received messages are saved */
+    uint8_t Valid;                                          /*!< Set to 1 when index is in sync with module */
+} GSM_SMS_Index_t;
+#endif /* GSM_SMS_INDEX */
+
 /**
  * \brief         SMS item
  */
@@ -280,6 +447,28 @@ typedef struct _GSM_SMS_Entry_t {
     GSM_DateTime_t DateTime;                                /*!< SMS date and time sent/received */
 } GSM_SMS_Entry_t;
 
+/**
+ * \brief         Callback function for streaming SMS list
+ * \param[in]     *entry: Pointer to parsed entry. Entry is overwritten with next message after function returns
+ * \param[in]     *arg: User argument
+ * \retval        1 to continue with next message or 0 to ignore remaining messages
+ */
+typedef uint8_t (*GSM_SMS_ListCallback_t)(const GSM_SMS_Entry_t* entry, void* arg);
+
+/**
+ * \brief         Ring buffer for directly delivered SMS (+CMT)
+ */
+typedef struct _GSM_SMS_Direct_t {
+    GSM_SMS_Entry_t* Entries;                               /*!< Pointer to array of entries */
+    uint16_t Size;                                          /*!< Number of entries in array */
+    uint32_t In;                                            /*!< Number of received messages, free running */
+    uint32_t Out;                                           /*!< Number of messages released by user, free running */
+    uint16_t Dropped;                                       /*!< Number of messages dropped because ring was full */
+    uint8_t Ack;                                            /*!< Set to 1 when stored messages are acknowledged with AT+CNMA */
+    uint8_t AckPending;                                     /*!< Number of messages waiting to be acknowledged */
+    uint8_t NackPending;                                    /*!< Number of dropped messages waiting for negative acknowledge with AT+CNMA=2 */
+} GSM_SMS_Direct_t;
+
 /**
  * \brief         Phonebook entry item
  */
@@ -317,17 +506,85 @@ typedef struct _GSM_CONN_t {
     uint16_t BytesReadRemaining;                            /*!< Number of bytes we have to read in current packet */
     uint16_t BytesRemaining;                                /*!< Number of bytes remaining to read in module buffer */
     uint16_t ReadTimeout;                                   /*!< Timeout before checking for new data when reading */
+    uint16_t SegmentSize;                                   /*!< Maximal number of bytes to send with single command */
+    uint16_t SegmentLimit;                                  /*!< Upper limit for automatic segment size growth, set by user or device */
+    uint16_t SendLatency;                                   /*!< Time in units of milliseconds needed for last packet to be sent */
+#if GSM_CONN_QSEND
+    uint32_t BytesAccepted;                                 /*!< Total number of bytes accepted by module in quick send mode */
+    uint32_t BytesAcked;                                    /*!< Total number of bytes acknowledged by remote side, updated with AT+CIPACK */
+#endif /* GSM_CONN_QSEND */
+#if GSM_CONN_RX_DGRAM
+    uint8_t* RxBuff;                                        /*!< Pointer to receive ring buffer, each packet is saved with 2-bytes length header */
+    uint16_t RxSize;                                        /*!< Size of receive ring buffer in units of bytes */
+    uint32_t RxIn;                                          /*!< Number of bytes written to ring buffer, free running */
+    uint32_t RxOut;                                         /*!< Number of bytes read from ring buffer, free running */
+    uint16_t RxDropped;                                     /*!< Number of packets dropped because receive buffer was full */
+#endif /* GSM_CONN_RX_DGRAM */
     union {
         struct {
             uint8_t Active:1;                               /*!< Connection active flag */
             uint8_t RxGetReceived:1;                        /*!< RXGET was received waiting to read data */
             uint8_t CallGetReceived:1;                      /*!< RXGET was received, notify user about new data */
             uint8_t CallConnClosed:1;                       /*!< Connection was closed by remote server */
+            uint8_t SendError:1;                            /*!< Last send operation on connection failed */
+            uint8_t CallAccepted:1;                         /*!< Connection was accepted by server, notify user */
+            uint8_t RxLengthKnown:1;                        /*!< Number of bytes remaining in module buffer is up to date */
+            uint8_t Opened:1;                               /*!< Connection was active at least once */
         } F;
         uint8_t Value;                                      /*!< Value containing all the flags in single memory */
     } Flags;                                                /*!< Union with all the listed flags */
 } GSM_CONN_t;
 
+/**
+ * \brief         Single datagram for \ref GSM_CONN_SendDatagrams function
+ */
+typedef struct _GSM_CONN_Datagram_t {
+    const void* Data;                                       /*!< Pointer to datagram data */
+    uint16_t Length;                                        /*!< Datagram length in units of bytes */
+} GSM_CONN_Datagram_t;
+
+/**
+ * \brief         Connection poll events enumeration
+ */
+typedef enum _GSM_CONN_PollEvent_t {
+    GSM_CONN_PollEvent_Readable = 0x01,                     /*!< Data are available to read on connection */
+    GSM_CONN_PollEvent_Writable = 0x02,                     /*!< Connection is active and stack is ready to send data */
+    GSM_CONN_PollEvent_Closed = 0x04,                       /*!< Connection was active and is now closed */
+    GSM_CONN_PollEvent_Error = 0x08,                        /*!< Last send operation on connection failed. Cleared once reported */
+    GSM_CONN_PollEvent_Idle = 0x10                          /*!< Connection was never opened */
+} GSM_CONN_PollEvent_t;
+
+/**
+ * \brief         Connection poll structure for \ref GSM_CONN_Poll function
+ */
+typedef struct _GSM_CONN_Poll_t {
+    GSM_CONN_t* Conn;                                       /*!< Pointer to connection to check */
+    uint8_t Events;                                         /*!< Events to check. This parameter can be bitwise OR of \ref GSM_CONN_PollEvent_t values */
+    uint8_t REvents;                                        /*!< Events ready on connection, set by \ref GSM_CONN_Poll function */
+} GSM_CONN_Poll_t;
+
+/**
+ * \brief         Single entry in persistent connection pool
+ */
+typedef struct _GSM_CONN_PoolEntry_t {
+    GSM_CONN_t Conn;                                        /*!< Connection structure */
+    char Host[GSM_CONN_POOL_HOST_LENGTH];                   /*!< Host name connection was made to */
+    uint16_t Port;                                          /*!< Port connection was made to */
+    uint8_t Type;                                           /*!< Connection type, member of \ref GSM_CONN_Type_t enumeration */
+    uint8_t SSL;                                            /*!< SSL status, member of \ref GSM_CONN_SSL_t enumeration */
+    uint8_t InUse;                                          /*!< Set to 1 when connection is handed out to user */
+    uint32_t LastUsed;                                      /*!< Time in units of milliseconds when connection was released */
+} GSM_CONN_PoolEntry_t;
+
+/**
+ * \brief         Single entry in DNS cache
+ */
+typedef struct _GSM_CONN_DNSEntry_t {
+    char Host[GSM_CONN_DNS_CACHE_HOST_LENGTH];              /*!< Host name */
+    char Addr[16];                                          /*!< Resolved IP address in string format */
+    uint32_t Time;                                          /*!< Time in units of milliseconds when host was resolved */
+} GSM_CONN_DNSEntry_t;
+
 /**
  * \brief         HTTP supported request methods
  */
@@ -337,6 +594,26 @@ typedef enum _GSM_HTTP_Method_t {
     GSM_HTTP_Method_HEAD = 0x02                             /*!< HTTP method HEAD */
 } GSM_HTTP_Method_t;
 
+/**
+ * \brief         Sink function for streaming HTTP response read
+ * \param[in]     *data: Pointer to chunk of response data or NULL when response was read completely
+ * \param[in]     len: Number of bytes in chunk or 0 when response was read completely
+ * \param[in]     offset: Position of chunk in response body
+ * \param[in]     total: Total number of bytes in response body
+ * \retval        1 to continue reading or 0 to stop
+ */
+typedef uint8_t (*GSM_HTTP_Sink_t)(const void* data, uint32_t len, uint32_t offset, uint32_t total);
+
+/**
+ * \brief         Producer function for streaming HTTP request body
+ * \param[out]    *buff: Pointer to buffer to fill with body data
+ * \param[in]     btw: Number of bytes to write to buffer
+ * \param[in]     offset: Position of data in request body
+ * \param[in]     total: Total number of bytes in request body
+ * \retval        Number of bytes written to buffer, 0 to stop upload
+ */
+typedef uint32_t (*GSM_HTTP_Producer_t)(void* buff, uint32_t btw, uint32_t offset, uint32_t total);
+
 /**
  * \brief         HTTP structure for GSM
  */
@@ -348,9 +625,17 @@ typedef struct _GSM_HTTP_t {
     uint32_t DataLength;                                    /*!< Length of data array in units of bytes */
     uint32_t BytesReceived;                                 /*!< Number of total bytes received by HTTP response from server to GSM */
     uint32_t BytesReadTotal;                                /*!< Total number of bytes we already read from GSM module HTTP response */
-    uint16_t BytesToRead;                                   /*!< Bytes to read from receive at a time, selected by user on function call */
+    uint32_t BytesToRead;                                   /*!< Bytes to read from receive at a time, selected by user on function call */
     uint32_t BytesRead;                                     /*!< Actual number of bytes read in last read procedure */
     uint32_t BytesReadRemaining;                            /*!< Number of bytes remaining to read in current read procedure */
+    GSM_HTTP_Sink_t Sink;                                   /*!< Sink function for streaming read */
+    GSM_HTTP_Producer_t Producer;                           /*!< Producer function for streaming upload */
+    uint32_t BodyOffset;                                    /*!< Position of response body in complete resource, non-zero for range responses */
+#if GSM_HTTP_SESSION
+    uint8_t SessionActive;                                  /*!< Set to 1 when HTTP service is initialized on module */
+    uint8_t ParamsValid;                                    /*!< Set to 1 when SSL parameter on module matches saved value */
+    uint8_t SSL;                                            /*!< SSL setting last sent to module */
+#endif /* GSM_HTTP_SESSION */
 } GSM_HTTP_t;
 
 /**
@@ -361,6 +646,35 @@ typedef enum _GSM_HTTP_SSL_t {
     GSM_HTTP_SSL_Enable = 0x01                              /*!< Enable SSL usage for HTTP */
 } GSM_HTTP_SSL_t;
 
+/**
+ * \brief         Resumable HTTP download structure
+ */
+typedef struct _GSM_HTTP_Download_t {
+    const char* URL;                                        /*!< URL of resource to download */
+    GSM_HTTP_SSL_t SSL;                                     /*!< SSL status for request */
+    uint32_t Offset;                                        /*!< Number of bytes already passed to sink function */
+    uint32_t Total;                                         /*!< Total size of resource or 0 if not known yet */
+    uint8_t Completed;                                      /*!< Set to 1 when complete resource was downloaded */
+} GSM_HTTP_Download_t;
+
+/**
+ * \brief         FTP sink function prototype for streaming download
+ * \param[in]     *data: Pointer to received data or NULL when download is finished
+ * \param[in]     len: Number of bytes in data array
+ * \param[in]     offset: Position of data in file
+ * \retval        1 to continue with download, 0 to stop
+ */
+typedef uint8_t (*GSM_FTP_Sink_t)(const void* data, uint32_t len, uint32_t offset);
+
+/**
+ * \brief         FTP producer function prototype for streaming upload
+ * \param[out]    *buff: Pointer to buffer to fill with data
+ * \param[in]     btw: Maximal number of bytes to write to buffer
+ * \param[in]     offset: Position of data in file
+ * \retval        Number of bytes written to buffer, 0 when there is no more data
+ */
+typedef uint32_t (*GSM_FTP_Producer_t)(void* buff, uint32_t btw, uint32_t offset);
+
 /**
  * \brief         FTP structure for GSM
  */
@@ -373,10 +687,20 @@ typedef struct _GSM_FTP_t {
     uint32_t BytesReadRemaining;                            /*!< Number of bytes remaining to read in current read procedure */
     uint32_t BytesProcessedTotal;                           /*!< Total number of bytes read in FTP session */
     uint32_t MaxBytesToPut;                                 /*!< Maximal number of bytes we can put on FTPPUT command */
+    GSM_FTP_Sink_t Sink;                                    /*!< Sink function for streaming download */
+    uint32_t FileSize;                                      /*!< File size reported by FTPSIZE command or size of file in module memory in extended get mode */
+    uint32_t ExtPosition;                                   /*!< Read position in module memory in extended get mode */
+    GSM_FTP_Producer_t Producer;                            /*!< Producer function for streaming upload */
+    uint32_t StageLength[2];                                /*!< Number of valid bytes in each staging buffer for streaming upload */
+    uint32_t StartTime;                                     /*!< Time when streaming transfer started */
+    uint32_t BytesPerSecond;                                /*!< Average throughput of streaming upload in units of bytes per second */
     union {
         struct {
             uint8_t DataAvailable:1;                        /*!< Set to 1 when data available to read */
             uint8_t DownloadActive:1;                       /*!< Set to 1 when download session is active */
+            uint8_t Aborted:1;                              /*!< Set to 1 when streaming transfer was stopped by user */
+            uint8_t Stage:1;                                /*!< Index of staging buffer being sent in streaming upload */
+            uint8_t CallProgress:1;                         /*!< Set to 1 when progress event should be called */
         } F;
         uint8_t Value;
     } Flags;                                                /*!< FTP Flags */
@@ -408,6 +732,38 @@ typedef enum _GSM_FTP_UploadMode_t {
     GSM_FTP_UploadMode_Store = 0x02
 } GSM_FTP_UploadMode_t;
 
+/**
+ * \brief         Single file transfer in FTP session batch
+ */
+typedef struct _GSM_FTP_Transfer_t {
+    uint8_t Upload;                                         /*!< Set to 1 to upload file, 0 to download it */
+    const char* Folder;                                     /*!< Folder of file on server */
+    const char* File;                                       /*!< File name in folder */
+    GSM_FTP_UploadMode_t UploadMode;                        /*!< Upload mode, used when uploading */
+    GSM_FTP_Sink_t Sink;                                    /*!< Sink function, used when downloading */
+    GSM_FTP_Producer_t Producer;                            /*!< Producer function, used when uploading */
+    GSM_Result_t Result;                                    /*!< Result of transfer */
+    uint32_t Bytes;                                         /*!< Number of bytes transferred */
+    uint32_t BytesPerSecond;                                /*!< Throughput of transfer in units of bytes per second */
+} GSM_FTP_Transfer_t;
+
+/**
+ * \brief         FTP session for multiple file transfers
+ */
+typedef struct _GSM_FTP_Session_t {
+    const char* Server;                                     /*!< Server host name or IP address */
+    uint16_t Port;                                          /*!< Server port */
+    const char* User;                                       /*!< User name */
+    const char* Pass;                                       /*!< Password */
+    GSM_FTP_Mode_t Mode;                                    /*!< FTP mode, active or passive */
+    GSM_FTP_SSL_t SSL;                                      /*!< FTP over SSL selection */
+    void* Buff;                                             /*!< Pointer to transfer buffer */
+    uint32_t Size;                                          /*!< Size of transfer buffer in units of bytes */
+    uint16_t FilesDone;                                     /*!< Number of files transferred successfully */
+    uint32_t Bytes;                                         /*!< Total number of bytes transferred in session */
+    uint32_t BytesPerSecond;                                /*!< Aggregate throughput of session in units of bytes per second */
+} GSM_FTP_Session_t;
+
 /**
  * \brief         GSM network status
  */
@@ -492,16 +848,22 @@ typedef enum _GSM_Func_t {
  */
 typedef enum _GSM_Event_t {
     gsmEventIdle = 0x00,                                    /*!< Stack went idle */
-    gsmEventDataReceived,                                   /*!< A new data received on connection */
+    gsmEventDataReceived,                                   /*!< A new data received on connection. CP1 is pointer to \ref GSM_CONN_t structure, UI is number of bytes waiting in module or 0 if not known */
     gsmEventDataSent,                                       /*!< Data were sent on connection */
     gsmEventDataSentError,                                  /*!< Data sent error */
+    gsmEventConnAccepted,                                   /*!< New connection was accepted by server. CP1 is pointer to \ref GSM_CONN_t structure */
 #if GSM_CALL
     gsmEventCallCLCC,                                       /*!< CLCC Call info was received with call data */
     gsmEventCallRING,                                       /*!< RING was received on call */
 #endif /* GSM_CALL */
 #if GSM_SMS
     gsmEventSMSCMTI,                                        /*!< SMS info was received */
+    gsmEventSMSQueueSent,                                   /*!< Message from send queue was processed. CP1 is pointer to \ref GSM_SMS_QueueEntry_t structure, CP2 is pointer to \ref GSM_SMS_Queue_t structure */
+    gsmEventSMSCMT,                                         /*!< Directly delivered SMS was received. CP1 is pointer to \ref GSM_SMS_Direct_t structure */
 #endif /* GSM_SMS */
+#if GSM_FTP
+    gsmEventFTPProgress,                                    /*!< Slice of streaming FTP upload was sent. CP1 is pointer to \ref GSM_FTP_t structure, UI is number of bytes uploaded */
+#endif /* GSM_FTP */
     gsmEventGPRSAttached,                                   /*!< GPRS has been attached */
     gsmEventGPRSAttachError,                                /*!< Error while trying to attach GPRS */
     gsmEventGPRSDetached,                                   /*!< GPRS has been detached */
@@ -540,6 +902,8 @@ typedef struct _GSM_t {
     gvol uint32_t ActiveCmdStart;                           /*!< Time when new command started with execution */
     gvol GSM_Result_t ActiveResult;                         /*!< Result to return from function */
     gvol uint32_t ActiveCmdTimeout;                         /*!< Timeout in units of MS for active command to finish */
+    gvol uint8_t InternalActive;                            /*!< Set to 1 when stack executes command on its own */
+    gvol uint8_t CmdRequest;                                /*!< Set to 1 when user function is starting new command */
     
     gvol GSM_NetworkStatus_t NetworkStatus;                 /*!< Network status enumeration */
 
@@ -554,11 +918,52 @@ typedef struct _GSM_t {
     
     /*!< Plain connections check */
     GSM_CONN_t* Conns[6];                                   /*!< Array of pointers to connections */
+    uint16_t ConnMaxSegmentSize;                            /*!< Maximal segment size on connection as reported by device */
+    GSM_CONN_t* ServerConns;                                /*!< Pointer to array of connections used for accepted connections in server mode */
+    uint8_t ServerConnsCount;                               /*!< Number of connections in server array */
+    uint8_t ConnReject;                                     /*!< Bit mask of connection IDs to close because no server connection structure was free */
+#if GSM_CONN_RX_LENGTH
+    uint8_t ConnRxLength;                                   /*!< Bit mask of connection IDs to read number of waiting bytes for */
+#endif /* GSM_CONN_RX_LENGTH */
+#if GSM_CONN_RX_DGRAM
+    GSM_CONN_t* ConnRxConn;                                 /*!< Connection to save currently received packet to or NULL to drop it */
+    uint32_t ConnRxPos;                                     /*!< Write position in receive buffer for currently received packet */
+    uint16_t ConnRxRemaining;                               /*!< Number of bytes of currently received packet still to come */
+#endif /* GSM_CONN_RX_DGRAM */
+#if GSM_CONN_TRANSPARENT
+    uint32_t TransparentLeft;                               /*!< Number of received bytes user has to read before remote close notification */
+    uint32_t TransparentScanned;                            /*!< Receive buffer position of next byte to check for remote close notification */
+    uint32_t TransparentMatchStart;                         /*!< Receive buffer position where possible remote close notification starts */
+    uint32_t TransparentRxTime;                             /*!< Time when last data were received in data mode */
+    uint8_t TransparentMatch;                               /*!< Number of bytes of remote close notification matched so far */
+    uint8_t TransparentClosed;                              /*!< Set to 1 when remote close notification was found in data stream */
+#endif /* GSM_CONN_TRANSPARENT */
+#if GSM_CONN_POOL
+    GSM_CONN_PoolEntry_t ConnPool[GSM_CONN_POOL];           /*!< Persistent connection pool */
+    GSM_CONN_PoolEntry_t* ConnPoolStart;                    /*!< Pool entry for connection currently being started */
+    GSM_CONN_t** ConnPoolOut;                               /*!< Pointer to save started pool connection to */
+#endif /* GSM_CONN_POOL */
+#if GSM_CONN_DNS_CACHE
+    GSM_CONN_DNSEntry_t DNSCache[GSM_CONN_DNS_CACHE];       /*!< DNS cache entries */
+    char DNSAddr[16];                                       /*!< Address of host used for current connection */
+    uint32_t DNSCacheHits;                                  /*!< Number of connections started with address from DNS cache */
+    uint32_t DNSCacheMisses;                                /*!< Number of connections where host name had to be resolved */
+#endif /* GSM_CONN_DNS_CACHE */
     
 #if GSM_SMS
     /*!< SMS management */
     GSM_SMS_t SMS;                                          /*!< SMS Send object */
     GSM_SmsInfo_t SmsInfos[GSM_MAX_RECEIVED_SMS_INFO];      /*!< Received SMS info object */
+    GSM_SMS_Direct_t* SmsDirect;                            /*!< Pointer to ring buffer for directly delivered SMS */
+    GSM_SMS_ListCallback_t SmsListCallback;                 /*!< Callback function for streaming SMS list */
+    void* SmsListArg;                                       /*!< User argument for streaming SMS list callback */
+    uint8_t SmsListStop;                                    /*!< Set to 1 when callback requested to ignore remaining messages */
+#if GSM_SMS_CMTI_QUEUE
+    GSM_SMS_Arrivals_t SmsArrivals;                         /*!< Queue of received SMS notifications */
+#endif /* GSM_SMS_CMTI_QUEUE */
+#if GSM_SMS_INDEX
+    GSM_SMS_Index_t SmsIndex;                               /*!< Index of message storage */
+#endif /* GSM_SMS_INDEX */
 #endif /* GSM_SMS */
 #if GSM_CALL   
     /*!< Call management */
@@ -596,6 +1001,9 @@ typedef struct _GSM_t {
             uint8_t SMS_SendError:1;                        /*!< We got an error trying to send SMS */
             uint8_t SMS_Read_Data:1;                        /*!< Set to 1 when we are reading actual SMS data */
             uint8_t SMS_CMTI_Received:1;                    /*!< Set to 1 when CMTI SMS info is received and callback should be called */
+            uint8_t SMS_CMT_Read_Data:1;                    /*!< Set to 1 when we are reading data of directly delivered SMS */
+            uint8_t SMS_CMT_Drop:1;                         /*!< Set to 1 when directly delivered SMS is ignored because ring is full */
+            uint8_t SMS_CMT_Received:1;                     /*!< Set to 1 when directly delivered SMS is received and callback should be called */
 #endif /* GSM_SMS */
 #if GSM_CALL            
             uint8_t CALL_CLCC_Received:1;                   /*!< Set to 1 when CLCC call info is received and callback should be called */
@@ -605,6 +1013,9 @@ typedef struct _GSM_t {
             uint8_t ReadSingleLineDataRespond:1;            /*!< Set to 1 when we have to read response from command like AT+CGMI. Data is returned as plain text without any special command before */
             
             uint8_t CLIENT_Read_Data:1;                     /*!< Set to 1 when we are reading raw data from client response */
+#if GSM_CONN_RX_DGRAM
+            uint8_t CLIENT_Recv_Data:1;                     /*!< Set to 1 when we are reading raw data of packet pushed with +RECEIVE */
+#endif /* GSM_CONN_RX_DGRAM */
             
 #if GSM_HTTP
             uint8_t HTTP_Read_Data:1;                       /*!< Set to 1 when reading data from HTTP response */
@@ -623,6 +1034,11 @@ typedef struct _GSM_t {
             
             uint8_t COPS_Read_Operators:1;                  /*!< Set to 1 when we should process incoming COPS data to read networks from scan */
             
+#if GSM_CONN_TRANSPARENT
+            uint8_t Transparent:1;                          /*!< Set to 1 when transparent mode is selected for connection */
+            uint8_t TransparentData:1;                      /*!< Set to 1 when device is in data mode and received data are not parsed */
+#endif /* GSM_CONN_TRANSPARENT */
+            
             uint8_t LastOperationStatus:1;
         } F;
         uint32_t Value;                                     /*!< Value containing all the flags in single memory */
@@ -643,6 +1059,10 @@ typedef struct _GSM_t {
             uint8_t RespCloseOk:1;                          /*!< n, CLOSE OK was returned from device */
             uint8_t RespSendOk:1;                           /*!< n, SEND OK was returned from device */
             uint8_t RespSendFail:1;                         /*!< n, SEND FAIL was returned from device */
+            uint8_t RespDataAccept:1;                       /*!< DATA ACCEPT was returned from device in quick send mode */
+            uint8_t RespServerOk:1;                         /*!< SERVER OK was returned from device */
+            uint8_t RespDNSOk:1;                            /*!< +CDNSGIP with resolved address was returned from device */
+            uint8_t RespDNSFail:1;                          /*!< +CDNSGIP with error was returned from device */
             
             uint8_t RespCallReady:1;                        /*!< Set to 1 when call is ready */
             uint8_t RespSMSReady:1;                         /*!< Set to 1 when SNS is ready */
@@ -655,6 +1075,8 @@ typedef struct _GSM_t {
             uint8_t RespFtpGet:1;                           /*!< Response for FTPGET was received */
             uint8_t RespFtpPut:1;                           /*!< Response for FTPPUT was received */
             uint8_t RespFtpUploadReady:1;                   /*!< Response for FTPPUT was received for uploading data available */
+            uint8_t RespFtpSize:1;                          /*!< Response for FTPSIZE was received */
+            uint8_t RespFtpExtGet:1;                        /*!< Response for FTPEXTGET was received */
 #endif /* GSM_FTP */
         } F;
         uint32_t Value;                                     /*!< Value containing all the flags in single memory */
@@ -1078,6 +1500,23 @@ GSM_Result_t GSM_SMS_Read(gvol GSM_t* GSM, uint16_t position, GSM_SMS_Entry_t* S
  */
 GSM_Result_t GSM_SMS_List(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, GSM_SMS_Entry_t* entries, uint16_t btr, uint16_t* br, uint32_t blocking);
 
+/**
+ * \brief         List SMS entries one by one to callback function
+ * \note          Each message is parsed to single scratch entry and passed to callback as soon as it is received,
+ *                   so there is no limit on number of listed messages.
+ *                   Callback is called from \ref GSM_Update function, do not call any API function from it.
+ *                   Save positions of messages to delete and delete them after function returns
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     type: SMS type to read. This parameter can be a value of \ref GSM_SMS_ReadType_t enumeration
+ * \param[out]    *scratch: Pointer to \ref GSM_SMS_Entry_t structure used to parse each message
+ * \param[in]     callback: Callback function called for each message
+ * \param[in]     *arg: User argument for callback function
+ * \param[out]    *br: Pointer to save number of messages passed to callback
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_ListStream(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, GSM_SMS_Entry_t* scratch, GSM_SMS_ListCallback_t callback, void* arg, uint16_t* br, uint32_t blocking);
+
 /**
  * \brief         Delete specific SMS at desired position
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
@@ -1116,6 +1555,164 @@ GSM_SmsInfo_t* GSM_SMS_GetReceivedInfo(gvol GSM_t* GSM, uint32_t blocking);
  */
 GSM_Result_t GSM_SMS_ClearReceivedInfo(gvol GSM_t* GSM, GSM_SmsInfo_t* info, uint32_t blocking);
 
+/**
+ * \brief         Get oldest received SMS notification from queue
+ * \note          \ref gsmEventSMSCMTI event is called once for multiple notifications received at a time.
+ *                   Call this function until it returns error to process all of them
+ * \note          After queue overflow, Reconcile member of \ref GSM_SMS_Arrivals_t is set.
+ *                   Process queue and call \ref GSM_SMS_ArrivalReconcile to find lost notifications
+ * \note          Function is available when \ref GSM_SMS_CMTI_QUEUE is greater than 0
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[out]    *info: Pointer to \ref GSM_SmsInfo_t structure to save memory and position of received SMS to
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_ArrivalGet(gvol GSM_t* GSM, GSM_SmsInfo_t* info);
+
+/**
+ * \brief         List unread messages and add them to notification queue after queue overflow
+ * \note          Call it when Reconcile member of \ref GSM_SMS_Arrivals_t is set and queue was emptied with \ref GSM_SMS_ArrivalGet.
+ *                   Memory of last notification is selected with AT+CPMS and stays selected for read and list operations.
+ *                   Read or delete processed messages, otherwise they are reported again on next call
+ * \note          Function is available when \ref GSM_SMS_CMTI_QUEUE is greater than 0
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_ArrivalReconcile(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Build index of message storage
+ * \note          Size of storage for received messages (last memory reported by AT+CPMS?) is read first.
+ *                   This memory is selected for list, read and delete and status of each message is read with single AT+CMGL command.
+ *                   Later index is updated on +CMTI notifications and on \ref GSM_SMS_Read, \ref GSM_SMS_ReadPDU,
+ *                   \ref GSM_SMS_Delete and \ref GSM_SMS_MassDelete functions
+ * \note          Function is available when \ref GSM_SMS_INDEX is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration. Error is returned also when storage is bigger than \ref GSM_SMS_INDEX_SIZE
+ */
+GSM_Result_t GSM_SMS_IndexSync(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Find positions of messages in storage index without communication with module
+ * \note          When index gets out of sync (for example position outside index is reported), error is returned
+ *                   and index must be built again with \ref GSM_SMS_IndexSync function
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     type: SMS type to find. This parameter can be a value of \ref GSM_SMS_ReadType_t enumeration
+ * \param[out]    *positions: Pointer to array to save positions to
+ * \param[in]     btr: Number of elements in positions array
+ * \param[out]    *br: Pointer to save number of positions found
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_IndexFind(gvol GSM_t* GSM, GSM_SMS_ReadType_t type, uint16_t* positions, uint16_t btr, uint16_t* br);
+
+/**
+ * \brief         Initialize SMS send queue
+ * \param[out]    *queue: Pointer to \ref GSM_SMS_Queue_t structure
+ * \param[in]     *entries: Pointer to array of \ref GSM_SMS_QueueEntry_t structures
+ * \param[in]     size: Number of entries in array
+ * \param[in]     retries: Number of retries for each message on error
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_QueueInit(GSM_SMS_Queue_t* queue, GSM_SMS_QueueEntry_t* entries, uint16_t size, uint8_t retries);
+
+/**
+ * \brief         Add message to SMS send queue
+ * \note          Messages can be added also while queue is being sent
+ * \param[in,out] *queue: Pointer to \ref GSM_SMS_Queue_t structure
+ * \param[in]     *number: Phone number to send SMS to. Must stay valid until message is sent
+ * \param[in]     *data: SMS data in ASCII format. Must stay valid until message is sent
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_QueueAdd(GSM_SMS_Queue_t* queue, const char* number, const char* data);
+
+/**
+ * \brief         Send all messages from SMS send queue
+ * \note          Text mode is entered once and messages are sent back to back without going to idle between them.
+ *                   Each processed message is reported with \ref gsmEventSMSQueueSent event.
+ *                   Event is called while queue is still being sent, do not call any API function from it.
+ *                   Function returns when all messages are processed. Queue must stay valid until last message
+ *                   is reported with event, stack does not use it after that
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in,out] *queue: Pointer to \ref GSM_SMS_Queue_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_QueueSend(gvol GSM_t* GSM, GSM_SMS_Queue_t* queue, uint32_t blocking);
+
+/**
+ * \brief         Send SMS of any length in PDU mode
+ * \note          Message is sent in GSM 7-bit alphabet when possible, otherwise in UCS2.
+ *                   When it does not fit into single SMS, it is split into concatenated parts automatically
+ * \note          Function is available when \ref GSM_SMS_PDU is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *number: Phone number to send SMS to, with optional leading '+' for international format
+ * \param[in]     *data: SMS data in UTF-8 format
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_SendLong(gvol GSM_t* GSM, const char* number, const char* data, uint32_t blocking);
+
+/**
+ * \brief         Initialize ring buffer for directly delivered SMS
+ * \param[out]    *direct: Pointer to \ref GSM_SMS_Direct_t structure
+ * \param[in]     *entries: Pointer to array of \ref GSM_SMS_Entry_t structures
+ * \param[in]     size: Number of entries in array
+ * \param[in]     ack: Set to 1 to acknowledge each message with AT+CNMA.
+ *                   Without acknowledge, network may consider message as not delivered and send it again
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_DirectInit(GSM_SMS_Direct_t* direct, GSM_SMS_Entry_t* entries, uint16_t size, uint8_t ack);
+
+/**
+ * \brief         Enable or disable direct delivery of received SMS
+ * \note          When enabled (AT+CNMI=2,2), messages are not stored to SIM and \ref gsmEventSMSCMTI event is not called.
+ *                   Each message is parsed to ring buffer and \ref gsmEventSMSCMT event is called instead
+ * \note          When acknowledge is enabled, it is sent automatically as soon as stack is idle, without changing state of user commands.
+ *                   Messages saved to ring buffer are acknowledged with AT+CNMA, dropped messages (full ring or PDU mode header)
+ *                   with AT+CNMA=2 so network delivers them again. Module disables direct delivery when acknowledge
+ *                   is not sent in few seconds, call this function again in that case
+ * 
+ote          On error, previously enabled ring buffer stays active
+ * \note          Function is available when \ref GSM_SMS_DIRECT is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *direct: Pointer to \ref GSM_SMS_Direct_t structure to enable direct delivery or NULL to store messages to SIM again
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_DirectEnable(gvol GSM_t* GSM, GSM_SMS_Direct_t* direct, uint32_t blocking);
+
+/**
+ * \brief         Get oldest directly delivered SMS
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \retval        Pointer to \ref GSM_SMS_Entry_t structure or NULL if there is no message in ring buffer
+ */
+GSM_SMS_Entry_t* GSM_SMS_DirectGet(gvol GSM_t* GSM);
+
+/**
+ * \brief         Release oldest directly delivered SMS after it is processed
+ * \note          You must call this function after you process message returned by \ref GSM_SMS_DirectGet function
+ *                   to allow new message to be saved to its entry
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_DirectRelease(gvol GSM_t* GSM);
+
+/**
+ * \brief         Read and decode SMS in PDU mode
+ * \note          Received PDU is decoded in place. On success, data of \ref GSM_PDU_t structure point inside buffer.
+ *                   Use \ref GSM_PDU_ConcatAdd to reassemble concatenated messages
+ * \note          Function is available when \ref GSM_SMS_PDU is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     position: SMS position in memory
+ * \param[out]    *buff: Pointer to buffer for received PDU. 353 bytes are enough for any message
+ * \param[in]     size: Size of buffer in units of bytes
+ * \param[out]    *pdu: Pointer to \ref GSM_PDU_t structure to save decoded message to
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_SMS_ReadPDU(gvol GSM_t* GSM, uint16_t position, char* buff, uint16_t size, GSM_PDU_t* pdu, uint32_t blocking);
+
 /**
  * \}
  */
@@ -1239,6 +1836,15 @@ GSM_Result_t GSM_GPRS_Attach(gvol GSM_t* GSM, const char* apn, const char* user,
  */
 GSM_Result_t GSM_GPRS_Detach(gvol GSM_t* GSM, uint32_t blocking);
 
+/**
+ * \brief         Opens bearer used by HTTP and FTP services again after it was lost
+ * \note          Module returns error when bearer is already opened
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_GPRS_BearerOpen(gvol GSM_t* GSM, uint32_t blocking);
+
 /**
  * \brief         Gets GPS location from GPRS and current UTC time
  * \note          Connection with GRPS must be active in order to get information
@@ -1287,8 +1893,49 @@ GSM_Result_t GSM_CONN_Start(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, GSM_CONN_Typ
  */
 GSM_Result_t GSM_CONN_Send(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const void* data, uint16_t btw, uint32_t* bw, uint32_t blocking);
 
+/**
+ * \brief         Start TCP server and listen for incoming connections
+ * \note          When new connection is accepted, free structure from array is used for it
+ *                   and \ref gsmEventConnAccepted event is called with pointer to connection.
+ *                   Accepted connections use the same send, receive and close functions as client connections.
+ *                   When all structures are in use, new connection is closed by stack as soon as it is idle
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     port: Port to listen on
+ * \param[in]     *conns: Pointer to array of \ref GSM_CONN_t structures for accepted connections
+ * \param[in]     count: Number of structures in array
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_ServerStart(gvol GSM_t* GSM, uint16_t port, GSM_CONN_t* conns, uint8_t count, uint32_t blocking);
+
+/**
+ * \brief         Stop TCP server
+ * \note          Already accepted connections stay active and must be closed with \ref GSM_CONN_Close function
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_ServerStop(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Send multiple datagrams on UDP connection in single command
+ * \note          Each datagram is sent with separate CIPSEND command and is never split to multiple packets.
+ *                   Stack does not go idle between datagrams and failed datagrams are not repeated.
+ *                   In quick send mode, send window is checked with AT+CIPACK before each datagram
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[in]     *dgrams: Pointer to array of \ref GSM_CONN_Datagram_t structures to send.
+ *                   Length of each datagram must not be greater than connection segment size
+ * \param[in]     count: Number of datagrams in array
+ * \param[out]    *sent: Pointer to save number of datagrams actually sent
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_SendDatagrams(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const GSM_CONN_Datagram_t* dgrams, uint16_t count, uint16_t* sent, uint32_t blocking);
+
 /**
  * \brief         Read received data on connection
+ * \note          When \ref GSM_CONN_RX_DGRAM is enabled, data are read from connection receive buffer as byte stream
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
  * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
  * \param[out]    *data: Pointer to data array to save receive data to
@@ -1301,6 +1948,51 @@ GSM_Result_t GSM_CONN_Send(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, const void* d
  */
 GSM_Result_t GSM_CONN_Receive(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint32_t* br, uint16_t timeBeforeRead, uint32_t blocking);
 
+/**
+ * \brief         Read all data waiting in module for connection, up to size of data array
+ * \note          When number of waiting bytes is not known, it is read from module first.
+ *                   Exactly that amount is then read with single command. When no data are waiting, function returns with 0 bytes read
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[out]    *data: Pointer to data array to save receive data to
+ * \param[in]     btr: Length of data array in units of bytes
+ * \param[out]    *br: Pointer to number of actually read bytes from response
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_ReceiveAvailable(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint32_t* br, uint32_t blocking);
+
+#if GSM_CONN_RX_DGRAM
+/**
+ * \brief         Set receive buffer for connection in automatic receive mode
+ * \note          This functions only sets parameter and does not inquiry GSM. Call it before connection is started
+ *                   or server is started with connection array. Each packet takes 2 more bytes in buffer for its length
+ * \note          Function is available only when \ref GSM_CONN_RX_DGRAM is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[in]     *buff: Pointer to receive buffer or NULL to drop received data
+ * \param[in]     size: Size of receive buffer in units of bytes
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_SetReceiveBuffer(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* buff, uint16_t size);
+
+/**
+ * \brief         Read oldest received datagram from connection receive buffer
+ * \note          This functions only reads receive buffer and does not inquiry GSM.
+ *                   When datagram is longer than data array, it is truncated and rest of it is discarded.
+ *                   Do not mix it with \ref GSM_CONN_Receive on the same connection, datagram partially read as stream
+ *                   is returned without its beginning
+ * \note          Function is available only when \ref GSM_CONN_RX_DGRAM is enabled
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[out]    *data: Pointer to data array to save datagram to
+ * \param[in]     btr: Length of data array in units of bytes
+ * \param[out]    *br: Pointer to save datagram length to, up to btr bytes
+ * \retval        Member of \ref GSM_Result_t enumeration, \ref gsmERROR when no datagram is waiting
+ */
+GSM_Result_t GSM_CONN_ReceiveDatagram(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, void* data, uint16_t btr, uint16_t* br);
+#endif /* GSM_CONN_RX_DGRAM */
+
 /**
  * \brief         Close active connection
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
@@ -1325,6 +2017,147 @@ GSM_Result_t GSM_CONN_Close(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint32_t blo
  */
 uint32_t GSM_CONN_DataAvailable(gvol GSM_t* GSM, const gvol GSM_CONN_t* conn, uint32_t blocking);
 
+/**
+ * \brief         Get number of bytes acknowledged by remote side on connection
+ * \note          Function is available only when \ref GSM_CONN_QSEND is enabled.
+ *                   In quick send mode, \ref GSM_CONN_Send returns number of bytes accepted by module
+ *                   and this function can be used to check how many of them were actually delivered.
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[out]    *acked: Pointer to save total number of bytes acknowledged by remote side. Set to NULL if not used
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_GetAck(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint32_t* acked, uint32_t blocking);
+
+/**
+ * \brief         Set segment size for connection
+ * \note          This functions only sets parameter and does not inquiry GSM.
+ *                   Segment size is set to maximal value reported by device on \ref GSM_CONN_Start call
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to working \ref GSM_CONN_t structure for connection
+ * \param[in]     size: Maximal number of bytes to send with single command.
+ *                   Value is limited to maximal segment size reported by device
+ *                   and is also upper limit for automatic segment size tuning
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_SetSegmentSize(gvol GSM_t* GSM, gvol GSM_CONN_t* conn, uint16_t size);
+
+/**
+ * \brief         Check multiple connections for readable, writable, closed and error status
+ * \note          This functions only checks flags and does not inquiry GSM.
+ *                   It means that when you are not in RTOS or ASYNC mode, 
+ *                   function calls \ref GSM_Update to parse incoming data while waiting
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in,out] *fds: Pointer to array of \ref GSM_CONN_Poll_t structures.
+ *                   REvents member is set for each entry with events ready on connection
+ * \param[in]     count: Number of entries in array
+ * \param[in]     timeout: Maximal time in units of milliseconds to wait for any event.
+ *                   Set to 0 to check status and return immediately
+ * \retval        Number of connections with at least one event ready
+ * \note          Connection structure must be zeroed before first use for \ref GSM_CONN_PollEvent_Idle to be valid
+ */
+uint32_t GSM_CONN_Poll(gvol GSM_t* GSM, GSM_CONN_Poll_t* fds, uint16_t count, uint32_t timeout);
+
+/**
+ * \brief         Select transparent or normal mode for connections
+ * \note          Function is available only when \ref GSM_CONN_TRANSPARENT is enabled.
+ *                   New mode is applied on next \ref GSM_GPRS_Attach function call.
+ *                   In transparent mode, \ref GSM_CONN_Start enters data mode when connection is established
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     enable: Set to 1 to use transparent mode or 0 to use normal multi connection mode
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_SetTransparent(gvol GSM_t* GSM, uint8_t enable);
+
+/**
+ * \brief         Send raw data on connection in transparent data mode
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *data: Pointer to data to send
+ * \param[in]     btw: Number of bytes to send
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_TransparentSend(gvol GSM_t* GSM, const void* data, uint16_t btw);
+
+/**
+ * \brief         Read raw data received on connection in transparent data mode
+ * \note          When connection is closed by remote side, device sends "CLOSED" string in data stream
+ *                   and goes back to command mode. Notification is accepted only when no more data follow it for 100 ms,
+ *                   same bytes inside payload are returned as data. Until then, possible notification is not returned to user.
+ *                   After that, stack marks connection as closed and returns only data received before notification.
+ *                   When all these data are read, stack goes back to command mode automatically
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[out]    *data: Pointer to data array to save received data to
+ * \param[in]     btr: Length of data array in units of bytes
+ * \retval        Number of bytes read from receive buffer
+ */
+uint32_t GSM_CONN_TransparentReceive(gvol GSM_t* GSM, void* data, uint32_t btr);
+
+/**
+ * \brief         Leave transparent data mode with "+++" escape sequence and go back to command mode
+ * \note          Connection stays active. All received data must be read with \ref GSM_CONN_TransparentReceive
+ *                   before escape sequence is sent, otherwise function fails with timeout and device stays in data mode.
+ *                   Use \ref GSM_CONN_TransparentResume to go back to data mode or \ref GSM_CONN_Close to close connection
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_TransparentExit(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Resume transparent data mode on active connection with ATO command
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_TransparentResume(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Get connection from persistent pool for specific host, port and SSL setting
+ * \note          When connection with same parameters is already established and not in use, it is returned immediately
+ *                   without any communication with device. Otherwise new connection is started on free pool entry.
+ *                   When there is no free entry, least recently used idle connection is closed first.
+ *                   In non-blocking mode, close is only started and function returns \ref gsmBUSY, call it again when stack is idle.
+ * \note          When connection is not needed anymore, release it with \ref GSM_CONN_PoolRelease instead of closing it
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[out]    **conn: Pointer to pointer to save connection structure to.
+ *                   It is set only when connection is established, pointer is set to NULL otherwise
+ * \param[in]     type: Connection type. This parameter can be a value of \ref GSM_CONN_Type_t enumeration
+ * \param[in]     ssl: SSL status. This parameter can be a value of \ref GSM_CONN_SSL_t enumeration
+ * \param[in]     *host: Host name or IP address. Must be shorter than \ref GSM_CONN_POOL_HOST_LENGTH
+ * \param[in]     port: Port to connect to
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_PoolGet(gvol GSM_t* GSM, GSM_CONN_t** conn, GSM_CONN_Type_t type, GSM_CONN_SSL_t ssl, const char* host, uint16_t port, uint32_t blocking);
+
+/**
+ * \brief         Release connection back to persistent pool
+ * \note          Connection stays open for next \ref GSM_CONN_PoolGet call to the same host.
+ *                   When remote side closes it meanwhile, pool entry is reused for new connection
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *conn: Pointer to connection received with \ref GSM_CONN_PoolGet function
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_PoolRelease(gvol GSM_t* GSM, GSM_CONN_t* conn);
+
+/**
+ * \brief         Close connections in pool which were not used longer than \ref GSM_CONN_POOL_IDLE_TIMEOUT
+ * \note          Function closes at most one connection per call and should be called periodically
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_PoolUpdate(gvol GSM_t* GSM, uint32_t blocking);
+
+/**
+ * \brief         Remove all entries from DNS cache
+ * \note          Hit and miss counters are reset too
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_CONN_DNSCacheFlush(gvol GSM_t* GSM);
+
 /**
  * \}
  */
@@ -1337,6 +2170,7 @@ uint32_t GSM_CONN_DataAvailable(gvol GSM_t* GSM, const gvol GSM_CONN_t* conn, ui
 
 /**
  * \brief         Begin with HTTP support on SIM module
+ * \note          When \ref GSM_HTTP_SESSION is enabled and session is already active, function returns immediately
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
  * \param[in]     blocking: Status whether this function should be blocking to check for response
  * \retval        Member of \ref GSM_Result_t enumeration
@@ -1366,14 +2200,36 @@ GSM_Result_t GSM_HTTP_SetContent(gvol GSM_t* GSM, const char* content, uint32_t
  * \brief         Set data to be sent on HTTP body for POST or PUT methods
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
  * \param[in]     *data: Data to be sent as body
- * \param[in]     btw: Number of bytes to send
+ * \param[in]     btw: Number of bytes to send, up to 319488 bytes
  * \param[in]     blocking: Status whether this function should be blocking to check for response
  * \retval        Member of \ref GSM_Result_t enumeration
  */
 GSM_Result_t GSM_HTTP_SetData(gvol GSM_t* GSM, const void* data, uint32_t btw, uint32_t blocking);
 
+/**
+ * \brief         Set data to be sent on HTTP body for POST or PUT methods using producer function
+ * \note          Body is requested from producer chunk by chunk and sent to module directly,
+ *                   so complete body never has to be in memory at a time
+ * \note          Producer function is called from processing context and must not return more than requested.
+ *                   Module input time is calculated from body size and \ref GSM_HTTP_STREAM_RATE.
+ *                   When producer returns 0 before complete body is sent, stack waits for input time to expire,
+ *                   clears partial body by restarting HTTP service and function returns \ref gsmABORTED.
+ *                   URL and other parameters have to be set again after that
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     btw: Total number of bytes in body, up to 319488 bytes
+ * \param[in]     *buff: Pointer to chunk buffer
+ * \param[in]     size: Size of chunk buffer in units of bytes
+ * \param[in]     producer: Producer function called to fill chunk buffer
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTP_SetDataStream(gvol GSM_t* GSM, uint32_t btw, void* buff, uint32_t size, GSM_HTTP_Producer_t producer, uint32_t blocking);
+
 /**
  * \brief         Execute HTTP request to server with given URL and method
+ * \note          When \ref GSM_HTTP_SESSION is enabled, SSL is sent only when changed from previous request.
+ *                   On network error (code 601), bearer and HTTP service are opened again and function returns error.
+ *                   Content type, user data and body are lost on module and have to be set again before request is repeated
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
  * \param[in]     *url: Remote URL to use starting with "http://" or "https://"
  * \param[in]     method: HTTP method to use. This parameter can be a value of \ref GSM_HTTP_Method_t enumeration
@@ -1408,6 +2264,55 @@ GSM_Result_t GSM_HTTP_Read(gvol GSM_t* GSM, void* data, uint32_t btr, uint32_t*
  */
 uint32_t GSM_HTTP_DataAvailable(gvol GSM_t* GSM, uint32_t blocking);
 
+/**
+ * \brief         Read complete HTTP response and pass it to sink function chunk by chunk
+ * \note          Chunks are read back to back without returning to user, each up to size of chunk buffer.
+ *                   Reading starts at current read position, so it can be used after \ref GSM_HTTP_Read calls too.
+ * \note          Sink function is called from processing context. Call with NULL data and 0 length means response was read completely
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *buff: Pointer to chunk buffer
+ * \param[in]     size: Size of chunk buffer in units of bytes
+ * \param[in]     sink: Sink function called for every chunk of data
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration, \ref gsmABORTED when sink function stopped reading
+ */
+GSM_Result_t GSM_HTTP_ReadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_HTTP_Sink_t sink, uint32_t blocking);
+
+/**
+ * \brief         Set user defined header for next HTTP requests, e.g. "Range: bytes=100-"
+ * \note          Header stays set on module until it is changed. Use empty string to remove it
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *data: Pointer to header string
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTP_SetUserData(gvol GSM_t* GSM, const char* data, uint32_t blocking);
+
+/**
+ * \brief         Initialize resumable download structure
+ * \param[out]    *dl: Pointer to \ref GSM_HTTP_Download_t structure
+ * \param[in]     *url: URL of resource to download. Must stay valid while download is used
+ * \param[in]     ssl: Enable SSL for HTTP. This parameter can be a value of \ref GSM_HTTP_SSL_t enumeration
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTP_DownloadInit(GSM_HTTP_Download_t* dl, const char* url, GSM_HTTP_SSL_t ssl);
+
+/**
+ * \brief         Download resource or continue download from last confirmed position
+ * \note          When part of resource was already downloaded, request is made with Range header.
+ *                   Data are passed to sink function with offset in complete resource.
+ *                   When function fails (for example on bearer drop), call it again to continue where it stopped.
+ *                   On network error (code 601) request is repeated once with range header set again
+ * \note          HTTP must be started with \ref GSM_HTTP_Begin function first. Function is always blocking
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in,out] *dl: Pointer to \ref GSM_HTTP_Download_t structure
+ * \param[in]     *buff: Pointer to chunk buffer
+ * \param[in]     size: Size of chunk buffer in units of bytes
+ * \param[in]     sink: Sink function called for every chunk of data
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTP_DownloadRun(gvol GSM_t* GSM, GSM_HTTP_Download_t* dl, void* buff, uint32_t size, GSM_HTTP_Sink_t sink);
+
 /**
  * \}
  */
@@ -1452,13 +2357,25 @@ GSM_Result_t GSM_FTP_Authenticate(gvol GSM_t* GSM, const char* server, uint16_t
 /**
  * \brief         Begin with file download session
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
- * \param[in]     *folder: Folder to use for file download
+ * \param[in]     *folder: Folder to use for file download. Set to NULL to keep folder from previous download
  * \param[in]     *file: File to download in specific folder. For some FTP servers, this parameter must start with "/" character
  * \param[in]     blocking: Status whether this function should be blocking to check for response
  * \retval        Member of \ref GSM_Result_t enumeration
  */
 GSM_Result_t GSM_FTP_DownloadBegin(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t blocking);
 
+/**
+ * \brief         Begin with FTP download session from specific position in file
+ * \note          Position is sent to server with AT+FTPREST command. Total number of processed bytes starts with offset
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *folder: Folder name where file is stored. Use "/" for root folder or NULL to keep folder from previous download
+ * \param[in]     *file: File to download in specific folder. For some FTP servers, this parameter must start with "/" character
+ * \param[in]     offset: Position in file to start download from
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_DownloadBeginAt(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t offset, uint32_t blocking);
+
 /**
  * \brief         Checks if FTP download session is active
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
@@ -1496,11 +2413,43 @@ GSM_Result_t GSM_FTP_Download(gvol GSM_t* GSM, void* data, uint32_t btr, uint32_
  */
 GSM_Result_t GSM_FTP_DownloadEnd(gvol GSM_t* GSM, uint32_t blocking);
 
+/**
+ * \brief         Download complete file and pass data to sink function
+ * \note          Download session must be started with \ref GSM_FTP_DownloadBegin function first.
+ *                   Next chunk is requested as soon as previous one is passed to sink
+ *                   or when module reports new data are ready, until module reports end of file
+ * \note          Sink is called with NULL data and 0 length when file is downloaded
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *buff: Pointer to chunk buffer
+ * \param[in]     size: Size of chunk buffer in units of bytes
+ * \param[in]     sink: Sink function called for every chunk of data
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_DownloadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_FTP_Sink_t sink, uint32_t blocking);
+
+/**
+ * \brief         Download file to sink function and resume after failure
+ * \note          When download fails, FTP session is closed, bearer is opened again
+ *                   and download continues from last byte accepted by sink
+ * \note          Function is always blocking
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *folder: Folder name where file is stored. Use "/" for root folder or NULL to keep folder from previous download
+ * \param[in]     *file: File to download in specific folder
+ * \param[in]     *buff: Pointer to chunk buffer
+ * \param[in]     size: Size of chunk buffer in units of bytes
+ * \param[in]     sink: Sink function called for every chunk of data
+ * \param[in,out] *offset: Pointer to position in file to start with. Updated with number of bytes accepted by sink
+ * \param[in]     retries: Number of times to resume download after failure
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_DownloadResume(gvol GSM_t* GSM, const char* folder, const char* file, void* buff, uint32_t size, GSM_FTP_Sink_t sink, uint32_t* offset, uint8_t retries);
+
 /**
  * \brief         Begin with file upload session
  * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
- * \param[in]     *folder: Folder to use for file download
- * \param[in]     *file: File to download in specific folder. For some FTP servers, this parameter must start with "/" character
+ * \param[in]     *folder: Folder to use for file upload. Set to NULL to keep folder from previous upload
+ * \param[in]     *file: File to upload in specific folder. For some FTP servers, this parameter must start with "/" character
  * \param[in]     mode: Upload mode. This parameter can be a value of \ref GSM_FTP_UploadMode_t enumeration
  * \param[in]     blocking: Status whether this function should be blocking to check for response
  * \retval        Member of \ref GSM_Result_t enumeration
@@ -1527,6 +2476,49 @@ GSM_Result_t GSM_FTP_Upload(gvol GSM_t* GSM, const void* data, uint32_t btw, uin
  */
 GSM_Result_t GSM_FTP_UploadEnd(gvol GSM_t* GSM, uint32_t blocking);
 
+/**
+ * \brief         Upload data from producer function to FTP server
+ * \note          Upload session must be started with \ref GSM_FTP_UploadBegin function first.
+ *                   Buffer is split to 2 staging buffers. Next slice is prepared by producer
+ *                   while previous one is sent to server by module
+ * \note          After each slice, \ref gsmEventFTPProgress event is called.
+ *                   Event is called while upload is still active, do not call any API function from it
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *buff: Pointer to buffer for both staging buffers
+ * \param[in]     size: Size of buffer in units of bytes. Each staging buffer has half of this size
+ * \param[in]     producer: Producer function called to fill staging buffer
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_UploadStream(gvol GSM_t* GSM, void* buff, uint32_t size, GSM_FTP_Producer_t producer, uint32_t blocking);
+
+/**
+ * \brief         Get size of file on FTP server
+ * \note          To resume interrupted upload, get size of partially uploaded file,
+ *                   start upload with \ref GSM_FTP_UploadMode_Append mode and continue with data from that position
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *folder: Folder name where file is stored. Use "/" for root folder
+ * \param[in]     *file: File name in specific folder
+ * \param[out]    *size: Pointer to save file size to
+ * \param[in]     blocking: Status whether this function should be blocking to check for response
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_GetSize(gvol GSM_t* GSM, const char* folder, const char* file, uint32_t* size, uint32_t blocking);
+
+/**
+ * \brief         Run batch of file transfers in single FTP session
+ * \note          FTP profile and credentials are set only once for whole batch.
+ *                   Folder is set only when it changes between transfers and session is closed once at the end
+ * \note          Batch continues when single transfer fails. Check result of each transfer in \ref GSM_FTP_Transfer_t structure
+ * \note          Function is always blocking
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in,out] *session: Pointer to \ref GSM_FTP_Session_t structure with server data and buffer
+ * \param[in,out] *transfers: Pointer to array of \ref GSM_FTP_Transfer_t structures
+ * \param[in]     count: Number of transfers in array
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_FTP_SessionRun(gvol GSM_t* GSM, GSM_FTP_Session_t* session, GSM_FTP_Transfer_t* transfers, uint16_t count);
+
 /**
  * \}
  */
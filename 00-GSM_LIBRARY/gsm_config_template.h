@@ -144,6 +144,239 @@
  */
 #define GSM_SMS                         1
 
+/**
+ * \brief  Enables (1) or disables (0) quick send mode (AT+CIPQSEND=1) for TCP/UDP connections
+ *
+ *         In quick send mode, module responds with "DATA ACCEPT" as soon as data are in its buffer
+ *         and does not wait for remote side to acknowledge them. This allows multiple packets to be in flight at a time.
+ *
+ * \note   Delivery of data is tracked with AT+CIPACK command, see \ref GSM_CONN_GetAck function.
+ */
+#define GSM_CONN_QSEND                  0
+
+/**
+ * \brief  Maximal number of bytes accepted by module but not yet acknowledged by remote side
+ *
+ * \note   When window is full, stack waits for acknowledge before it sends next packet.
+ *         Used only when \ref GSM_CONN_QSEND is enabled.
+ */
+#define GSM_CONN_QSEND_WINDOW           4380
+
+/**
+ * \brief  Maximal time in units of milliseconds to wait for remote side to acknowledge data when send window is full
+ *
+ * \note   Acknowledge is checked with AT+CIPACK every 200 milliseconds.
+ *         Used only when \ref GSM_CONN_QSEND is enabled.
+ */
+#define GSM_CONN_QSEND_ACK_TIMEOUT      10000
+
+/**
+ * \brief  Timeout in units of milliseconds for each step of \ref GSM_CONN_Send and \ref GSM_CONN_SendDatagrams
+ *
+ * \note   Timeout is applied to every AT command sent as part of operation, not to whole operation.
+ */
+#define GSM_CONN_SEND_TIMEOUT           10000
+
+/**
+ * \brief  Enables (1) or disables (0) automatic tuning of segment size on connections
+ *
+ *         Segment size is the maximal number of bytes sent on connection with single command.
+ *         Maximal value is read from module on GPRS attach (AT+CIPSEND?).
+ *         When enabled, segment size is halved on each SEND FAIL and slowly increased back on successful sends,
+ *         but never above the value set with \ref GSM_CONN_SetSegmentSize.
+ *
+ * \note   Segment size can also be set manually with \ref GSM_CONN_SetSegmentSize function.
+ */
+#define GSM_CONN_SEGMENT_AUTO           1
+
+/**
+ * \brief  Enables (1) or disables (0) transparent mode support (AT+CIPMODE=1) for single connection
+ *
+ *         In transparent mode, UART carries raw connection data in both directions without AT command framing.
+ *         Received data are read directly from receive buffer with \ref GSM_CONN_TransparentReceive function.
+ *
+ * \note   When transparent mode is selected, only single connection can be used at a time.
+ *         Make sure \ref GSM_BUFFER_SIZE is big enough to hold data between 2 read calls.
+ */
+#define GSM_CONN_TRANSPARENT            1
+
+/**
+ * \brief  Number of connections in persistent connection pool. Set to 0 to disable pool
+ *
+ *         Pool keeps connections established after use and hands them out again
+ *         for next request to the same host, port and SSL setting, see \ref GSM_CONN_PoolGet function.
+ *
+ * \note   Each pool entry holds its own \ref GSM_CONN_t structure and a copy of host name.
+ */
+#define GSM_CONN_POOL                   2
+
+/**
+ * \brief  Maximal length of host name in connection pool, including string termination character
+ */
+#define GSM_CONN_POOL_HOST_LENGTH       48
+
+/**
+ * \brief  Time in units of milliseconds after which unused connection in pool is closed
+ *
+ * \note   Idle connections are closed with \ref GSM_CONN_PoolUpdate function. Set to 0 to keep them open forever.
+ */
+#define GSM_CONN_POOL_IDLE_TIMEOUT      60000
+
+/**
+ * \brief  Number of entries in DNS cache for connections. Set to 0 to disable cache
+ *
+ *         When enabled, host name is resolved with AT+CDNSGIP command before connection is started
+ *         and connection is made to resolved IP address. Next connections to the same host use cached address.
+ *
+ * \note   When connection to cached address fails, host name is resolved again and connection is retried.
+ */
+#define GSM_CONN_DNS_CACHE              4
+
+/**
+ * \brief  Time in units of milliseconds resolved address is valid in DNS cache
+ *
+ * \note   Module does not report TTL of DNS record, so this value is used for all entries.
+ */
+#define GSM_CONN_DNS_CACHE_TTL          300000
+
+/**
+ * \brief  Maximal length of host name in DNS cache, including string termination character
+ */
+#define GSM_CONN_DNS_CACHE_HOST_LENGTH  48
+
+/**
+ * \brief  Enables (1) or disables (0) reading number of pending bytes before new data notification
+ *
+ *         When enabled, stack reads number of bytes waiting in module (AT+CIPRXGET=4) when new data are received
+ *         and reports it with \ref gsmEventDataReceived event. Data can then be read with single read command.
+ *
+ * \note   Number of bytes is read as soon as no user command is active. User functions called meanwhile
+ *         wait for this command to finish instead of returning \ref gsmBUSY.
+ */
+#define GSM_CONN_RX_LENGTH              1
+
+/**
+ * \brief  Enables (1) or disables (0) automatic receive mode with datagram boundaries
+ *
+ *         When enabled, module pushes received data with "+RECEIVE,<n>,<len>:" header (AT+CIPRXGET=0, AT+CIPHEAD=1)
+ *         instead of manual read with AT+CIPRXGET. Every received packet is saved to connection receive buffer
+ *         set with \ref GSM_CONN_SetReceiveBuffer together with its length, so UDP datagrams can be read
+ *         one by one with \ref GSM_CONN_ReceiveDatagram. \ref GSM_CONN_Receive reads the same buffer as byte stream.
+ *
+ * \note   Mode is selected on module for all connections, so each connection (including server connections)
+ *         needs receive buffer. Packets which do not fit to buffer are dropped.
+ */
+#define GSM_CONN_RX_DGRAM               0
+
+/**
+ * \brief  Enables (1) or disables (0) persistent HTTP session
+ *
+ *         When enabled, HTTP service stays initialized between requests until \ref GSM_HTTP_End is called.
+ *         SSL parameter is sent to module only when it changes
+ *         and bearer and HTTP service are opened again when request fails with network error.
+ *
+ * \note   Used only when \ref GSM_HTTP is enabled.
+ */
+#define GSM_HTTP_SESSION                1
+
+/**
+ * \brief  Minimal rate in units of bytes per second at which producer function delivers body for \ref GSM_HTTP_SetDataStream
+ *
+ *         Module input time for body is calculated from this value. When producer stops upload,
+ *         stack waits for input time to expire before module accepts new commands.
+ */
+#define GSM_HTTP_STREAM_RATE            2000
+
+/**
+ * \brief  Enables (1) or disables (0) HTTP/1.1 client on top of TCP connections (gsm_http_client.c)
+ *
+ *         Client supports persistent connections, request pipelining and chunked transfer encoding
+ *         and does not use built-in HTTP service of module.
+ */
+#define GSM_HTTP_CLIENT                 1
+
+/**
+ * \brief  Timeout in units of milliseconds for HTTP client to wait for new data from server
+ */
+#define GSM_HTTP_CLIENT_TIMEOUT         30000
+
+/**
+ * \brief  Enables (1) or disables (0) extended get mode (AT+FTPEXTGET) for FTP downloads
+ *
+ *         When enabled, complete file is downloaded to module memory on \ref GSM_FTP_DownloadBegin
+ *         and later download functions read it from module memory without waiting for FTP server on each chunk.
+ *
+ * \note   File must fit into module memory. Used only when \ref GSM_FTP is enabled.
+ */
+#define GSM_FTP_EXTGET                  0
+
+/**
+ * \brief  Maximal time in units of milliseconds to wait for file to be downloaded to module memory
+ *
+ *         Used instead of normal command timeout while \ref GSM_FTP_DownloadBegin waits for complete file.
+ *         Set it according to expected file size and network speed.
+ *
+ * \note   Used only when \ref GSM_FTP_EXTGET is enabled.
+ */
+#define GSM_FTP_EXTGET_TIMEOUT          600000
+
+/**
+ * \brief  Enables (1) or disables (0) SMS in PDU mode (gsm_pdu.c)
+ *
+ *         PDU mode supports messages longer than single SMS (concatenated SMS)
+ *         and characters outside GSM 7-bit alphabet (UCS2), see \ref GSM_SMS_SendLong and \ref GSM_SMS_ReadPDU functions.
+ *
+ * \note   Used only when \ref GSM_SMS is enabled.
+ */
+#define GSM_SMS_PDU                     1
+
+/**
+ * \brief  Maximal number of parts of concatenated SMS accepted on reassembly, up to 32
+ */
+#define GSM_SMS_CONCAT_PARTS            4
+
+/**
+ * \brief  Time in units of milliseconds after which incomplete concatenated SMS is dropped from reassembly table
+ */
+#define GSM_SMS_CONCAT_TIMEOUT          300000
+
+/**
+ * \brief  Enables (1) or disables (0) direct delivery of received SMS (+CMT)
+ *
+ *         When direct delivery is enabled with \ref GSM_SMS_DirectEnable function, received messages
+ *         are not stored to SIM and are parsed directly to ring buffer of entries, set by user.
+ *
+ * \note   Used only when \ref GSM_SMS is enabled.
+ */
+#define GSM_SMS_DIRECT                  1
+
+/**
+ * \brief  Number of entries in queue of received SMS notifications (+CMTI). Set to 0 to disable queue
+ *
+ *         Each notification is saved to queue and read with \ref GSM_SMS_ArrivalGet function.
+ *         When queue overflows, user calls \ref GSM_SMS_ArrivalReconcile once queue is empty again
+ *         to list unread messages (AT+CMGL) and add them to queue, so no received message is lost.
+ *
+ * \note   Used only when \ref GSM_SMS is enabled.
+ */
+#define GSM_SMS_CMTI_QUEUE              16
+
+/**
+ * \brief  Enables (1) or disables (0) index of message storage
+ *
+ *         Index keeps status of each position in message storage. It is built once with \ref GSM_SMS_IndexSync function
+ *         and then updated on received, read and deleted messages, so unread or occupied positions
+ *         can be found with \ref GSM_SMS_IndexFind function without listing messages from module.
+ *
+ * \note   Used only when \ref GSM_SMS is enabled.
+ */
+#define GSM_SMS_INDEX                   1
+
+/**
+ * \brief  Maximal number of positions in message storage tracked by index
+ */
+#define GSM_SMS_INDEX_SIZE              50
+
 /**
  * \}
  */
@@ -0,0 +1,463 @@
+/**
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2016 Tilen Majerle
+ * |
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software,
+ * | and to permit persons to whom the Software is furnished to do so,
+ * | subject to the following conditions:
+ * |
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * |
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "gsm_http_client.h"
+
+#if GSM_HTTP_CLIENT
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private definitions                          **/
+/******************************************************************************/
+/******************************************************************************/
+#define HTTPC_LINE_SIZE                     128
+#define HTTPC_CHARTOLOWER(x)                ((x) >= 'A' && (x) <= 'Z' ? (x) - 'A' + 'a' : (x))
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Compares first n characters of strings case insensitive */
+static
+uint8_t StrNCaseEqual(const char* a, const char* b, uint16_t n) {
+    while (n--) {
+        if (HTTPC_CHARTOLOWER(*a) != HTTPC_CHARTOLOWER(*b)) {
+            return 0;
+        }
+        if (!*a) {
+            break;
+        }
+        a++;
+        b++;
+    }
+    return 1;
+}
+
+/* Skips leading spaces in string */
+static
+const char* SkipSpaces(const char* str) {
+    while (*str == ' ' || *str == '\t') {
+        str++;
+    }
+    return str;
+}
+
+/* Checks if headers string includes header with given name */
+static
+uint8_t HasHeader(const char* headers, const char* name) {
+    uint16_t nlen = strlen(name);
+
+    while (headers != NULL && *headers) {
+        if (StrNCaseEqual(headers, name, nlen) && headers[nlen] == ':') {
+            return 1;
+        }
+        while (*headers && *headers++ != '\n');             /* Go to next header */
+    }
+    return 0;
+}
+
+/* Appends string to request buffer, returns 0 when it does not fit */
+static
+uint8_t AppendString(GSM_HTTPC_t* c, uint16_t* n, const char* str) {
+    while (*str) {
+        if (*n >= c->TxBuffSize - 1) {
+            return 0;
+        }
+        c->TxBuff[(*n)++] = *str++;
+    }
+    c->TxBuff[*n] = 0;
+    return 1;
+}
+
+/* Appends number as decimal string to request buffer, returns 0 when it does not fit */
+static
+uint8_t AppendNumber(GSM_HTTPC_t* c, uint16_t* n, uint32_t number) {
+    char str[11];
+    uint8_t i = sizeof(str) - 1;
+
+    str[i] = 0;
+    do {                                                    /* Convert digits from the last one */
+        str[--i] = '0' + number % 10;
+        number /= 10;
+    } while (number);
+    return AppendString(c, n, &str[i]);
+}
+
+/* Fills receive buffer with new data from connection */
+static
+GSM_Result_t Fill(GSM_HTTPC_t* c) {
+    uint32_t br, elapsed, start = c->GSM->Time;
+    GSM_CONN_Poll_t fd;
+    GSM_Result_t res;
+
+    fd.Conn = &c->Conn;                                     /* Wait for data or close on connection */
+    fd.Events = GSM_CONN_PollEvent_Readable | GSM_CONN_PollEvent_Closed;
+    c->RxPos = 0;
+    c->RxLength = 0;
+    while (1) {
+        if (GSM_CONN_DataAvailable(c->GSM, &c->Conn, 1)) {  /* Read everything available at once */
+            res = GSM_CONN_ReceiveAvailable(c->GSM, &c->Conn, c->RxBuff, c->RxBuffSize, &br, 1);
+            if (res != gsmOK) {
+                return res;
+            }
+            if (br) {
+                c->RxLength = br;
+                return gsmOK;
+            }
+        } else if (!c->Conn.Flags.F.Active) {               /* Connection closed and no more data */
+            return gsmERROR;
+        }
+        elapsed = c->GSM->Time - start;
+        if (elapsed >= GSM_HTTP_CLIENT_TIMEOUT) {
+            return gsmTIMEOUT;
+        }
+        GSM_CONN_Poll(c->GSM, &fd, 1, GSM_HTTP_CLIENT_TIMEOUT - elapsed);  /* Wait for new data */
+    }
+}
+
+/* Reads single line without line ending. When line is longer than buffer, rest of it is discarded and cut is set to 1 */
+static
+GSM_Result_t ReadLine(GSM_HTTPC_t* c, char* line, uint16_t size, uint8_t* cut) {
+    GSM_Result_t res;
+    uint16_t i = 0;
+    char ch;
+
+    if (cut != NULL) {
+        *cut = 0;
+    }
+    while (1) {
+        if (c->RxPos >= c->RxLength && (res = Fill(c)) != gsmOK) {
+            return res;
+        }
+        ch = (char)c->RxBuff[c->RxPos++];
+        if (ch == '\n') {
+            break;
+        }
+        if (ch == '\r') {
+            continue;
+        }
+        if (i < size - 1) {
+            line[i++] = ch;
+        } else if (cut != NULL) {                           /* Character does not fit, it is discarded */
+            *cut = 1;
+        }
+    }
+    line[i] = 0;
+    return gsmOK;
+}
+
+/* Passes body data to sink, until len bytes are read or until connection is closed */
+static
+GSM_Result_t ReadBody(GSM_HTTPC_t* c, GSM_HTTPC_Response_t* resp, uint32_t len, uint8_t toclose, GSM_HTTP_Sink_t sink) {
+    GSM_Result_t res;
+    uint32_t n;
+
+    while (len || toclose) {
+        if (c->RxPos >= c->RxLength && (res = Fill(c)) != gsmOK) {
+            return toclose && res == gsmERROR ? gsmOK : res;    /* Closed connection ends body without length */
+        }
+        n = c->RxLength - c->RxPos;
+        if (!toclose && n > len) {
+            n = len;
+        }
+        if (sink && !sink(&c->RxBuff[c->RxPos], n, resp->BytesRead, resp->ContentLength < 0 ? 0 : resp->ContentLength)) {
+            return gsmERROR;                                /* User stopped reading */
+        }
+        c->RxPos += n;
+        resp->BytesRead += n;
+        if (!toclose) {
+            len -= n;
+        }
+    }
+    return gsmOK;
+}
+
+/* Sends data on connection in pieces supported by connection API */
+static
+GSM_Result_t Send(GSM_HTTPC_t* c, const uint8_t* data, uint32_t len) {
+    GSM_Result_t res;
+    uint32_t bw;
+    uint16_t btw;
+
+    while (len) {
+        btw = len > 0xFFFF ? 0xFFFF : len;
+        if ((res = GSM_CONN_Send(c->GSM, &c->Conn, data, btw, &bw, 1)) != gsmOK) {
+            return res;
+        }
+        data += btw;
+        len -= btw;
+    }
+    return gsmOK;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+GSM_Result_t GSM_HTTPC_Init(GSM_HTTPC_t* client, gvol GSM_t* GSM, const char* host, uint16_t port, GSM_CONN_SSL_t ssl, void* rxbuff, uint16_t rxsize, char* txbuff, uint16_t txsize) {
+    if (client == NULL || GSM == NULL || host == NULL || rxbuff == NULL || !rxsize || txbuff == NULL || !txsize) {
+        return gsmPARERROR;
+    }
+    memset(client, 0x00, sizeof(GSM_HTTPC_t));             /* Reset structure */
+    client->GSM = GSM;
+    client->Host = host;
+    client->Port = port;
+    client->SSL = ssl;
+    client->RxBuff = rxbuff;
+    client->RxBuffSize = rxsize;
+    client->TxBuff = txbuff;
+    client->TxBuffSize = txsize;
+
+    return gsmOK;
+}
+
+GSM_Result_t GSM_HTTPC_SendRequest(GSM_HTTPC_t* client, const char* method, const char* path, const char* headers, const void* body, uint32_t len) {
+    GSM_Result_t res;
+    uint16_t n = 0;
+    uint8_t ok;
+
+    if (client == NULL || method == NULL || path == NULL || (len && body == NULL) || client->Pending >= 32) {
+        return gsmPARERROR;
+    }
+
+    if (!client->Conn.Flags.F.Active) {                     /* Start connection when not active */
+        client->Pending = 0;                                /* Responses on old connection are lost */
+        client->PendingHead = 0;
+        client->RxLength = 0;
+        client->RxPos = 0;
+        if ((res = GSM_CONN_Start(client->GSM, &client->Conn, GSM_CONN_Type_TCP, client->SSL, client->Host, client->Port, 1)) != gsmOK) {
+            return res;
+        }
+    }
+
+    /* Format request line and headers */
+    ok = AppendString(client, &n, method) && AppendString(client, &n, " ") &&
+        AppendString(client, &n, path) && AppendString(client, &n, " HTTP/1.1\r\nHost: ") &&
+        AppendString(client, &n, client->Host) && AppendString(client, &n, "\r\n");
+    if (ok && !HasHeader(headers, "Connection")) {          /* User headers can override connection type */
+        ok = AppendString(client, &n, "Connection: keep-alive\r\n");
+    }
+    if (ok && headers != NULL) {
+        ok = AppendString(client, &n, headers);
+    }
+    if (ok && (len || !strcmp(method, "POST") || !strcmp(method, "PUT"))) {
+        ok = AppendString(client, &n, "Content-Length: ") && AppendNumber(client, &n, len) && AppendString(client, &n, "\r\n");
+    }
+    if (ok) {
+        ok = AppendString(client, &n, "\r\n");
+    }
+    if (!ok) {                                              /* Headers do not fit to buffer */
+        return gsmPARERROR;
+    }
+    if (len && (uint32_t)n + len <= client->TxBuffSize) {   /* Send small body together with headers */
+        memcpy(&client->TxBuff[n], body, len);
+        n += len;
+        len = 0;
+    }
+
+    if ((res = Send(client, (const uint8_t *)client->TxBuff, n)) != gsmOK ||
+        (res = Send(client, (const uint8_t *)body, len)) != gsmOK) {
+        GSM_HTTPC_Close(client);                            /* Request was sent partially */
+        return res;
+    }
+
+    if (!strcmp(method, "HEAD")) {                          /* Response to HEAD has no body */
+        client->PendingHead |= (uint32_t)1 << client->Pending;
+    }
+    client->Pending++;                                      /* Wait for new response */
+    return gsmOK;
+}
+
+GSM_Result_t GSM_HTTPC_ReadResponse(GSM_HTTPC_t* client, GSM_HTTPC_Response_t* resp, GSM_HTTP_Sink_t sink) {
+    char line[HTTPC_LINE_SIZE];
+    GSM_Result_t res;
+    const char* value;
+    char* end;
+    uint32_t len;
+    uint16_t l;
+    uint8_t head, cut;
+
+    if (client == NULL || resp == NULL) {
+        return gsmPARERROR;
+    }
+    if (!client->Pending) {                                 /* No request was sent */
+        return gsmERROR;
+    }
+    head = client->PendingHead & 0x01;                      /* Get oldest request */
+    client->PendingHead >>= 1;
+    client->Pending--;
+
+    do {                                                    /* Interim (1xx) responses are skipped, final response follows */
+        resp->Code = 0;                                     /* Reset response */
+        resp->HeadersLength = 0;
+        resp->ContentLength = -1;
+        resp->BytesRead = 0;
+        resp->Chunked = 0;
+        resp->KeepAlive = 1;
+        if (resp->Headers != NULL && resp->HeadersSize) {
+            resp->Headers[0] = 0;
+        }
+
+        /* Read status line */
+        do {
+            if ((res = ReadLine(client, line, sizeof(line), NULL)) != gsmOK) {
+                goto error;
+            }
+        } while (!line[0]);
+        if (strncmp(line, "HTTP/1.", 7) != 0 || strlen(line) < 12) {
+            res = gsmERROR;
+            goto error;
+        }
+        if (line[7] == '0') {                               /* HTTP/1.0 closes connection by default */
+            resp->KeepAlive = 0;
+        }
+        resp->Code = atoi(&line[9]);
+
+        /* Read headers */
+        while (1) {
+            if ((res = ReadLine(client, line, sizeof(line), &cut)) != gsmOK) {
+                goto error;
+            }
+            if (!line[0]) {                                 /* Empty line ends headers */
+                break;
+            }
+            if (cut) {                                      /* Header is too long, it is ignored */
+                continue;
+            }
+            if (StrNCaseEqual(line, "Content-Length:", 15)) {
+                resp->ContentLength = atol(&line[15]);
+            } else if (StrNCaseEqual(line, "Transfer-Encoding:", 18)) {
+                resp->Chunked = StrNCaseEqual(SkipSpaces(&line[18]), "chunked", 7);
+            } else if (StrNCaseEqual(line, "Connection:", 11)) {
+                value = SkipSpaces(&line[11]);
+                if (StrNCaseEqual(value, "close", 5)) {
+                    resp->KeepAlive = 0;
+                } else if (StrNCaseEqual(value, "keep-alive", 10)) {
+                    resp->KeepAlive = 1;
+                }
+            }
+            l = strlen(line);
+            if (resp->Headers != NULL && resp->HeadersLength + l + 3 <= resp->HeadersSize) {   /* Save header for user */
+                memcpy(&resp->Headers[resp->HeadersLength], line, l);
+                resp->HeadersLength += l;
+                resp->Headers[resp->HeadersLength++] = '\r';
+                resp->Headers[resp->HeadersLength++] = '\n';
+                resp->Headers[resp->HeadersLength] = 0;
+            }
+        }
+    } while (resp->Code / 100 == 1 && resp->Code != 101);  /* Switching protocols is final response */
+
+    /* Read body */
+    if (head || resp->Code / 100 == 1 || resp->Code == 204 || resp->Code == 304) {
+        /* Response has no body */
+    } else if (resp->Chunked) {                             /* Decode chunked body */
+        while (1) {
+            if ((res = ReadLine(client, line, sizeof(line), NULL)) != gsmOK) {
+                goto error;
+            }
+            len = strtoul(line, &end, 16);                  /* Get chunk size */
+            if (end == line) {                              /* Chunk size is not valid */
+                res = gsmERROR;
+                goto error;
+            }
+            if (!len) {                                     /* Last chunk, skip trailers */
+                do {
+                    if ((res = ReadLine(client, line, sizeof(line), NULL)) != gsmOK) {
+                        goto error;
+                    }
+                } while (line[0]);
+                break;
+            }
+            if ((res = ReadBody(client, resp, len, 0, sink)) != gsmOK ||
+                (res = ReadLine(client, line, sizeof(line), NULL)) != gsmOK) {  /* Read chunk and its line ending */
+                goto error;
+            }
+        }
+    } else if (resp->ContentLength >= 0) {                  /* Body with known length */
+        if ((res = ReadBody(client, resp, resp->ContentLength, 0, sink)) != gsmOK) {
+            goto error;
+        }
+    } else {                                                /* Body ends when connection is closed */
+        resp->KeepAlive = 0;
+        if ((res = ReadBody(client, resp, 0, 1, sink)) != gsmOK) {
+            goto error;
+        }
+    }
+    if (sink) {
+        sink(NULL, 0, resp->BytesRead, resp->BytesRead);    /* Notify about end of body */
+    }
+
+    if (!resp->KeepAlive) {                                 /* Server closes connection */
+        GSM_HTTPC_Close(client);
+    }
+    return gsmOK;
+
+error:
+    GSM_HTTPC_Close(client);                                /* Position in stream is not known anymore */
+    return res;
+}
+
+GSM_Result_t GSM_HTTPC_GetHeader(const GSM_HTTPC_Response_t* resp, const char* name, char* value, uint16_t size) {
+    const char* str;
+    uint16_t nlen, i;
+
+    if (resp == NULL || name == NULL || value == NULL || !size || resp->Headers == NULL) {
+        return gsmPARERROR;
+    }
+    nlen = strlen(name);
+    for (str = resp->Headers; *str; ) {
+        if (StrNCaseEqual(str, name, nlen) && str[nlen] == ':') {  /* Header found */
+            str = SkipSpaces(&str[nlen + 1]);
+            for (i = 0; i < size - 1 && str[i] && str[i] != '\r'; i++) {
+                value[i] = str[i];
+            }
+            value[i] = 0;
+            return gsmOK;
+        }
+        while (*str && *str++ != '\n');                     /* Go to next header */
+    }
+    return gsmERROR;
+}
+
+GSM_Result_t GSM_HTTPC_Close(GSM_HTTPC_t* client) {
+    GSM_Result_t res = gsmOK;
+
+    if (client == NULL) {
+        return gsmPARERROR;
+    }
+    if (client->Conn.Flags.F.Active) {                      /* Close active connection */
+        res = GSM_CONN_Close(client->GSM, &client->Conn, 1);
+    }
+    client->Pending = 0;                                    /* Discard pending responses */
+    client->PendingHead = 0;
+    client->RxLength = 0;
+    client->RxPos = 0;
+
+    return res;
+}
+
+#endif /* GSM_HTTP_CLIENT */
@@ -0,0 +1,168 @@
+/**
+ * \author  Tilen Majerle
+ * \email   tilen@majerle.eu
+ * \website https://majerle.eu/projects/gsm-at-commands-parser-for-embedded-systems
+ * \license MIT
+ * \brief   HTTP/1.1 client on top of GSM TCP connections
+ *
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2016 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GSM_HTTP_CLIENT_H
+#define GSM_HTTP_CLIENT_H 100
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gsm.h"
+
+/**
+ * \addtogroup GSM
+ * \{
+ */
+
+/**
+ * \defgroup      HTTPC_API
+ * \brief         HTTP/1.1 client implemented on TCP connection layer
+ * \{
+ *
+ * Unlike built-in HTTP service of module, client keeps connection to server open between requests,
+ * allows multiple requests to be sent before responses are read (pipelining)
+ * and streams response body to user as it is received, including chunked transfer encoding.
+ *
+ * \note          Client uses blocking connection functions and must not be used from event callback
+ */
+
+/**
+ * \brief         HTTP client structure
+ */
+typedef struct _GSM_HTTPC_t {
+    gvol GSM_t* GSM;                                        /*!< Pointer to working \ref GSM_t structure */
+    GSM_CONN_t Conn;                                        /*!< Connection to server */
+    const char* Host;                                       /*!< Server host name */
+    uint16_t Port;                                          /*!< Server port */
+    GSM_CONN_SSL_t SSL;                                     /*!< SSL status for connection */
+    uint8_t* RxBuff;                                        /*!< Pointer to receive buffer */
+    uint16_t RxBuffSize;                                    /*!< Size of receive buffer in units of bytes */
+    uint16_t RxLength;                                      /*!< Number of valid bytes in receive buffer */
+    uint16_t RxPos;                                         /*!< Read position in receive buffer */
+    char* TxBuff;                                           /*!< Pointer to buffer for request headers */
+    uint16_t TxBuffSize;                                    /*!< Size of request buffer in units of bytes */
+    uint8_t Pending;                                        /*!< Number of requests sent without response read yet */
+    uint32_t PendingHead;                                   /*!< Bit mask of pending requests with HEAD method, bit 0 is oldest request */
+} GSM_HTTPC_t;
+
+/**
+ * \brief         HTTP client response structure
+ */
+typedef struct _GSM_HTTPC_Response_t {
+    uint16_t Code;                                          /*!< HTTP response code */
+    char* Headers;                                          /*!< Pointer to buffer for response headers, set by user. Can be NULL */
+    uint16_t HeadersSize;                                   /*!< Size of headers buffer in units of bytes, set by user */
+    uint16_t HeadersLength;                                 /*!< Number of bytes written to headers buffer */
+    int32_t ContentLength;                                  /*!< Length of response body or -1 if not known */
+    uint32_t BytesRead;                                     /*!< Number of body bytes received */
+    uint8_t Chunked;                                        /*!< Set to 1 when body uses chunked transfer encoding */
+    uint8_t KeepAlive;                                      /*!< Set to 1 when server keeps connection open after response */
+} GSM_HTTPC_Response_t;
+
+/**
+ * \brief         Initialize HTTP client structure
+ * \note          Connection to server is started on first request
+ * \param[out]    *client: Pointer to \ref GSM_HTTPC_t structure to initialize
+ * \param[in,out] *GSM: Pointer to working \ref GSM_t structure
+ * \param[in]     *host: Server host name. Must stay valid while client is used
+ * \param[in]     port: Server port
+ * \param[in]     ssl: SSL status. This parameter can be a value of \ref GSM_CONN_SSL_t enumeration
+ * \param[in]     *rxbuff: Pointer to buffer for received data
+ * \param[in]     rxsize: Size of receive buffer in units of bytes
+ * \param[in]     *txbuff: Pointer to buffer for request headers
+ * \param[in]     txsize: Size of request buffer in units of bytes
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTPC_Init(GSM_HTTPC_t* client, gvol GSM_t* GSM, const char* host, uint16_t port, GSM_CONN_SSL_t ssl, void* rxbuff, uint16_t rxsize, char* txbuff, uint16_t txsize);
+
+/**
+ * \brief         Send HTTP request to server
+ * \note          Multiple requests can be sent before responses are read with \ref GSM_HTTPC_ReadResponse function.
+ *                   Responses are returned in the same order as requests were sent
+ * \param[in,out] *client: Pointer to \ref GSM_HTTPC_t structure
+ * \param[in]     *method: Request method, e.g. "GET" or "POST"
+ * \param[in]     *path: Request path, e.g. "/index.html"
+ * \param[in]     *headers: Additional request headers, each terminated with "\r\n". Can be NULL.
+ *                   "Connection: keep-alive" is added unless Connection header is included here
+ * \param[in]     *body: Pointer to request body. Can be NULL
+ * \param[in]     len: Length of request body in units of bytes
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTPC_SendRequest(GSM_HTTPC_t* client, const char* method, const char* path, const char* headers, const void* body, uint32_t len);
+
+/**
+ * \brief         Read response for oldest request sent to server
+ * \note          Body is passed to sink function as it is received. When server closes connection after response,
+ *                   connection is started again on next request
+ * \note          Interim (1xx) responses are skipped, except 101. Header lines longer than 127 characters are ignored
+ * \param[in,out] *client: Pointer to \ref GSM_HTTPC_t structure
+ * \param[in,out] *resp: Pointer to \ref GSM_HTTPC_Response_t structure to fill
+ * \param[in]     sink: Sink function for response body. Set to NULL to discard body
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTPC_ReadResponse(GSM_HTTPC_t* client, GSM_HTTPC_Response_t* resp, GSM_HTTP_Sink_t sink);
+
+/**
+ * \brief         Get value of response header
+ * \param[in]     *resp: Pointer to \ref GSM_HTTPC_Response_t structure with received headers
+ * \param[in]     *name: Header name, compared case insensitive
+ * \param[out]    *value: Pointer to buffer to save header value to
+ * \param[in]     size: Size of value buffer in units of bytes
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTPC_GetHeader(const GSM_HTTPC_Response_t* resp, const char* name, char* value, uint16_t size);
+
+/**
+ * \brief         Close connection to server
+ * \note          Responses for pending requests are discarded
+ * \param[in,out] *client: Pointer to \ref GSM_HTTPC_t structure
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_HTTPC_Close(GSM_HTTPC_t* client);
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
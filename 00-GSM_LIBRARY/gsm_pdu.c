@@ -0,0 +1,663 @@
+/**
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2016 Tilen Majerle
+ * |
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software,
+ * | and to permit persons to whom the Software is furnished to do so,
+ * | subject to the following conditions:
+ * |
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * |
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#include "gsm_pdu.h"
+
+#if GSM_SMS && GSM_SMS_PDU
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private definitions                          **/
+/******************************************************************************/
+/******************************************************************************/
+#define PDU_ESC                             0x1B            /* Escape to extension table in GSM alphabet */
+#define PDU_SINGLE_GSM7                     160             /* Septets in single message */
+#define PDU_SINGLE_UCS2                     70              /* UCS2 units in single message */
+#define PDU_PART_GSM7                       153             /* Septets in part of concatenated message */
+#define PDU_PART_UCS2                       67              /* UCS2 units in part of concatenated message */
+#define PDU_UDH_LENGTH                      6               /* Length of concatenation header, including length octet */
+#define PDU_HEX_BUFF                        32              /* Characters sent to output function at a time */
+
+/* Encoder state */
+typedef struct {
+    char Buff[PDU_HEX_BUFF];                                /* Hexadecimal characters waiting for output */
+    uint8_t Len;                                            /* Number of characters in buffer */
+    uint16_t Acc;                                           /* Bit accumulator for septet packing */
+    uint8_t Bits;                                           /* Number of bits in accumulator */
+    GSM_PDU_Output_t Out;                                   /* Output function */
+    void* Arg;                                              /* Output function argument */
+} PDU_Writer_t;
+
+/* GSM 7-bit default alphabet to unicode, escape character is never matched */
+static const uint16_t GSM7Basic[128] = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC, 0x00F2, 0x00C7, 0x000A, 0x00D8, 0x00F8, 0x000D, 0x00C5, 0x00E5,
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8, 0x03A3, 0x0398, 0x039E, 0x0000, 0x00C6, 0x00E6, 0x00DF, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x00A1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,
+    0x00BF, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0
+};
+
+/* GSM 7-bit extension table, characters are preceded with escape character */
+static const struct {
+    uint8_t Code;
+    uint16_t Unicode;
+} GSM7Ext[] = {
+    {0x0A, 0x000C}, {0x14, 0x005E}, {0x28, 0x007B}, {0x29, 0x007D}, {0x2F, 0x005C},
+    {0x3C, 0x005B}, {0x3D, 0x007E}, {0x3E, 0x005D}, {0x40, 0x007C}, {0x65, 0x20AC}
+};
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Reads next character from UTF-8 string and moves pointer after it */
+static
+uint32_t UTF8Next(const char** str) {
+    const uint8_t* s = (const uint8_t *)*str;
+    uint32_t cp = *s++;
+    uint8_t n = 0;
+
+    if (cp >= 0xF8 || (cp >= 0x80 && cp < 0xC0)) {         /* Invalid first byte */
+        cp = 0xFFFD;
+    } else if (cp >= 0xF0) {
+        cp &= 0x07;
+        n = 3;
+    } else if (cp >= 0xE0) {
+        cp &= 0x0F;
+        n = 2;
+    } else if (cp >= 0xC0) {
+        cp &= 0x1F;
+        n = 1;
+    }
+    while (n && (*s & 0xC0) == 0x80) {
+        cp = (cp << 6) | (*s++ & 0x3F);
+        n--;
+    }
+    if (n || cp > 0x10FFFF) {                               /* Truncated sequence or out of range */
+        cp = 0xFFFD;
+    }
+    *str = (const char *)s;
+    return cp;
+}
+
+/* Gets number of bytes for character in UTF-8 format */
+static
+uint8_t UTF8Length(uint32_t cp) {
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+/* Writes character in UTF-8 format and returns number of bytes written */
+static
+uint8_t UTF8Put(uint8_t* out, uint32_t cp) {
+    static const uint8_t lead[] = {0x00, 0x00, 0xC0, 0xE0, 0xF0};
+    uint8_t len = UTF8Length(cp), i;
+
+    if (len == 1) {
+        out[0] = cp;
+        return 1;
+    }
+    for (i = len - 1; i > 0; i--) {
+        out[i] = 0x80 | (cp & 0x3F);
+        cp >>= 6;
+    }
+    out[0] = lead[len] | cp;                                /* Leading byte with length bits */
+    return len;
+}
+
+/* Finds character in GSM alphabet, returns code with bit 8 set for extension table or -1 if not found */
+static
+int16_t GSM7Find(uint32_t cp) {
+    uint8_t i;
+
+    for (i = 0; i < 128; i++) {
+        if (GSM7Basic[i] == cp) {
+            return i;
+        }
+    }
+    for (i = 0; i < sizeof(GSM7Ext) / sizeof(GSM7Ext[0]); i++) {
+        if (GSM7Ext[i].Unicode == cp) {
+            return 0x100 | GSM7Ext[i].Code;
+        }
+    }
+    return -1;
+}
+
+/* Gets number of septets or UCS2 units used by character */
+static
+uint8_t CharUnits(uint32_t cp, GSM_PDU_DCS_t dcs) {
+    if (dcs == GSM_PDU_DCS_GSM7) {
+        return GSM7Find(cp) > 0xFF ? 2 : 1;
+    }
+    return cp > 0xFFFF ? 2 : 1;                             /* Surrogate pair */
+}
+
+/* Finds end of part starting at text, returns number of units in part */
+static
+uint16_t PartEnd(const char* text, GSM_PDU_DCS_t dcs, uint8_t parts, const char** end) {
+    uint16_t max, units = 0;
+    const char* next;
+    uint8_t u;
+
+    if (dcs == GSM_PDU_DCS_GSM7) {
+        max = parts > 1 ? PDU_PART_GSM7 : PDU_SINGLE_GSM7;
+    } else {
+        max = parts > 1 ? PDU_PART_UCS2 : PDU_SINGLE_UCS2;
+    }
+    while (*text) {
+        next = text;
+        u = CharUnits(UTF8Next(&next), dcs);
+        if (units + u > max) {                              /* Character does not fit, do not split it */
+            break;
+        }
+        units += u;
+        text = next;
+    }
+    *end = text;
+    return units;
+}
+
+/* Gets number of digits in phone number */
+static
+uint8_t NumberDigits(const char* number) {
+    uint8_t digits = 0;
+
+    for (; *number; number++) {
+        if (*number >= '0' && *number <= '9') {
+            digits++;
+        }
+    }
+    return digits;
+}
+
+/* Writes octet as 2 hexadecimal characters */
+static
+void WriteOctet(PDU_Writer_t* w, uint8_t b) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    w->Buff[w->Len++] = hex[b >> 4];
+    w->Buff[w->Len++] = hex[b & 0x0F];
+    if (w->Len == sizeof(w->Buff)) {                        /* Flush full buffer */
+        w->Out(w->Buff, w->Len, w->Arg);
+        w->Len = 0;
+    }
+}
+
+/* Adds bits to accumulator, LSB first, and writes complete octets */
+static
+void WriteBits(PDU_Writer_t* w, uint8_t val, uint8_t bits) {
+    w->Acc |= (uint16_t)val << w->Bits;
+    w->Bits += bits;
+    while (w->Bits >= 8) {
+        WriteOctet(w, w->Acc & 0xFF);
+        w->Acc >>= 8;
+        w->Bits -= 8;
+    }
+}
+
+/* Gets septet at index from packed data */
+static
+uint8_t Septet(const uint8_t* b, uint16_t index) {
+    uint16_t k = (index * 7) >> 3;
+    uint8_t sh = (index * 7) & 0x07;
+    uint8_t val = b[k] >> sh;
+
+    if (sh > 1) {                                           /* Septet continues in next octet */
+        val |= b[k + 1] << (8 - sh);
+    }
+    return val & 0x7F;
+}
+
+/* Gets value of hexadecimal character or -1 on error */
+static
+int8_t HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Decodes originating address to string */
+static
+void DecodeAddress(const uint8_t* b, uint8_t digits, uint8_t type, char* str, uint8_t size) {
+    uint8_t i, pos = 0, d;
+
+    if ((type & 0x70) == 0x50) {                            /* Alphanumeric address, GSM 7-bit packed */
+        for (i = 0; i < digits * 4 / 7 && pos + 1 < size; i++) {
+            d = Septet(b, i);
+            str[pos++] = GSM7Basic[d] && GSM7Basic[d] < 0x80 ? GSM7Basic[d] : '?';
+        }
+    } else {
+        if ((type & 0x70) == 0x10 && pos + 1 < size) {      /* International number */
+            str[pos++] = '+';
+        }
+        for (i = 0; i < digits && pos + 1 < size; i++) {
+            d = (i & 1) ? b[i >> 1] >> 4 : b[i >> 1] & 0x0F;
+            str[pos++] = d < 10 ? '0' + d : d == 0x0A ? '*' : '#';
+        }
+    }
+    str[pos] = 0;
+}
+
+/* Gets unicode character from decoded user data, returns number of bytes used */
+static
+uint8_t DataChar(const uint8_t* d, uint16_t len, GSM_PDU_DCS_t dcs, uint32_t* cp) {
+    uint8_t i;
+
+    if (dcs == GSM_PDU_DCS_GSM7) {
+        if (d[0] == PDU_ESC) {
+            if (len < 2) {                                  /* Escape at the end of data */
+                *cp = ' ';
+                return 1;
+            }
+            for (i = 0; i < sizeof(GSM7Ext) / sizeof(GSM7Ext[0]); i++) {
+                if (GSM7Ext[i].Code == d[1]) {
+                    *cp = GSM7Ext[i].Unicode;
+                    return 2;
+                }
+            }
+            *cp = GSM7Basic[d[1] & 0x7F];                   /* Unknown extension is shown as basic character */
+            if (!*cp) {
+                *cp = ' ';
+            }
+            return 2;
+        }
+        *cp = GSM7Basic[d[0] & 0x7F];
+        return 1;
+    }
+    if (len < 2) {                                          /* Odd number of bytes in UCS2 data */
+        *cp = 0xFFFD;
+        return 1;
+    }
+    *cp = ((uint32_t)d[0] << 8) | d[1];
+    if (*cp >= 0xD800 && *cp < 0xDC00 && len >= 4 && (d[2] & 0xFC) == 0xDC) { /* Surrogate pair */
+        *cp = 0x10000 + ((*cp - 0xD800) << 10) + ((((uint32_t)d[2] << 8) | d[3]) - 0xDC00);
+        return 4;
+    }
+    return 2;
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+uint8_t GSM_PDU_CountParts(const char* text, GSM_PDU_DCS_t* dcs) {
+    const char* p = text;
+    uint16_t parts = 0;
+
+    *dcs = GSM_PDU_DCS_GSM7;
+    while (*p) {
+        if (GSM7Find(UTF8Next(&p)) < 0) {                   /* Character not in GSM alphabet */
+            *dcs = GSM_PDU_DCS_UCS2;
+            break;
+        }
+    }
+
+    PartEnd(text, *dcs, 1, &p);                             /* Check if it fits single message */
+    if (!*p) {
+        return 1;
+    }
+    p = text;
+    while (*p && parts < 255) {
+        PartEnd(p, *dcs, 2, &p);
+        parts++;
+    }
+    return *p ? 0 : parts;
+}
+
+uint16_t GSM_PDU_PartLength(const char* number, const char* text, GSM_PDU_DCS_t dcs, uint8_t parts, const char** end) {
+    uint16_t units = PartEnd(text, dcs, parts, end);
+    uint16_t len;
+
+    len = 4 + (NumberDigits(number) + 1) / 2 + 3;           /* First octet, MR, address length and type, address, PID, DCS, UDL */
+    if (dcs == GSM_PDU_DCS_GSM7) {
+        len += (((parts > 1 ? 7 : 0) + units) * 7 + 7) / 8;
+    } else {
+        len += (parts > 1 ? PDU_UDH_LENGTH : 0) + units * 2;
+    }
+    return len;
+}
+
+void GSM_PDU_WritePart(const char* number, const char* text, const char* end, GSM_PDU_DCS_t dcs, uint8_t ref, uint8_t part, uint8_t parts, GSM_PDU_Output_t out, void* arg) {
+    PDU_Writer_t w;
+    const char* p;
+    uint16_t units = 0;
+    uint32_t cp;
+    int16_t c;
+
+    memset(&w, 0x00, sizeof(w));
+    w.Out = out;
+    w.Arg = arg;
+
+    WriteOctet(&w, 0x00);                                   /* Use service centre stored on SIM */
+    WriteOctet(&w, parts > 1 ? 0x41 : 0x01);                /* SMS-SUBMIT, user data header present for concatenated message */
+    WriteOctet(&w, 0x00);                                   /* Message reference is set by module */
+    WriteOctet(&w, NumberDigits(number));                   /* Address length in digits */
+    WriteOctet(&w, *number == '+' ? 0x91 : 0x81);           /* International or national number */
+    c = -1;
+    for (p = number; *p; p++) {                             /* Digits in swapped nibbles */
+        if (*p < '0' || *p > '9') {
+            continue;
+        }
+        if (c < 0) {
+            c = *p - '0';
+        } else {
+            WriteOctet(&w, ((*p - '0') << 4) | c);
+            c = -1;
+        }
+    }
+    if (c >= 0) {                                           /* Pad odd number of digits */
+        WriteOctet(&w, 0xF0 | c);
+    }
+    WriteOctet(&w, 0x00);                                   /* Protocol identifier */
+    WriteOctet(&w, dcs);                                    /* Data coding scheme */
+
+    for (p = text; p < end; ) {
+        units += CharUnits(UTF8Next(&p), dcs);
+    }
+    if (dcs == GSM_PDU_DCS_GSM7) {                          /* User data length in septets */
+        WriteOctet(&w, (parts > 1 ? 7 : 0) + units);
+    } else {                                                /* User data length in octets */
+        WriteOctet(&w, (parts > 1 ? PDU_UDH_LENGTH : 0) + units * 2);
+    }
+    if (parts > 1) {                                        /* Concatenation header with 8-bit reference */
+        WriteBits(&w, 0x05, 8);
+        WriteBits(&w, 0x00, 8);
+        WriteBits(&w, 0x03, 8);
+        WriteBits(&w, ref, 8);
+        WriteBits(&w, parts, 8);
+        WriteBits(&w, part, 8);
+        if (dcs == GSM_PDU_DCS_GSM7) {
+            WriteBits(&w, 0x00, 1);                         /* Fill bit to align text to septet boundary */
+        }
+    }
+
+    for (p = text; p < end; ) {
+        cp = UTF8Next(&p);
+        if (dcs == GSM_PDU_DCS_GSM7) {
+            c = GSM7Find(cp);
+            if (c < 0) {
+                c = '?';
+            } else if (c > 0xFF) {
+                WriteBits(&w, PDU_ESC, 7);
+            }
+            WriteBits(&w, c & 0x7F, 7);
+        } else {
+            if (cp > 0xFFFF) {                              /* Surrogate pair */
+                cp -= 0x10000;
+                WriteBits(&w, 0xD8 | (cp >> 18), 8);
+                WriteBits(&w, (cp >> 10) & 0xFF, 8);
+                cp = 0xDC00 | (cp & 0x3FF);
+            }
+            WriteBits(&w, cp >> 8, 8);
+            WriteBits(&w, cp & 0xFF, 8);
+        }
+    }
+    if (w.Bits) {                                           /* Write remaining bits */
+        WriteOctet(&w, w.Acc & 0xFF);
+    }
+    if (w.Len) {
+        out(w.Buff, w.Len, arg);
+    }
+}
+
+GSM_Result_t GSM_PDU_Decode(char* hex, GSM_PDU_t* pdu) {
+    uint8_t* b = (uint8_t *)hex;
+    uint16_t n, p, i, j, hdr = 0;
+    uint8_t fo, len, type, dcs, udl, udhl = 0;
+    int8_t h, l;
+
+    if (hex == NULL || pdu == NULL) {
+        return gsmPARERROR;
+    }
+    memset(pdu, 0x00, sizeof(*pdu));
+
+    for (n = 0; hex[2 * n] && hex[2 * n + 1]; n++) {        /* Convert to binary in place, output is always behind input */
+        h = HexValue(hex[2 * n]);
+        l = HexValue(hex[2 * n + 1]);
+        if (h < 0 || l < 0) {
+            return gsmERROR;
+        }
+        b[n] = (h << 4) | l;
+    }
+
+    if (!n || 1 + b[0] + 3 > n) {
+        return gsmERROR;
+    }
+    p = 1 + b[0];                                           /* Skip service centre address */
+    fo = b[p++];
+    if ((fo & 0x03) != 0x00) {                              /* Only SMS-DELIVER is supported */
+        return gsmERROR;
+    }
+    len = b[p++];                                           /* Address length in digits */
+    type = b[p++];
+    if (p + (len + 1) / 2 + 10 > n) {                       /* Address, PID, DCS, time stamp and UDL must be present */
+        return gsmERROR;
+    }
+    DecodeAddress(&b[p], len, type, pdu->Number, sizeof(pdu->Number));
+    p += (len + 1) / 2;
+    p++;                                                    /* Skip protocol identifier */
+    dcs = b[p++];
+    p += 7;                                                 /* Skip service centre time stamp */
+    udl = b[p++];
+
+    if ((dcs & 0x80) == 0x00) {                             /* General data coding */
+        dcs = (dcs >> 2) & 0x03;
+    } else if ((dcs & 0xF0) == 0xF0) {                      /* Data coding and message class */
+        dcs = (dcs >> 2) & 0x01;
+    } else if ((dcs & 0xF0) == 0xE0) {                      /* Message waiting group with UCS2 data */
+        dcs = 0x02;
+    } else {
+        dcs = 0x00;
+    }
+    pdu->DCS = dcs == 0x02 ? GSM_PDU_DCS_UCS2 : dcs == 0x01 ? GSM_PDU_DCS_8BIT : GSM_PDU_DCS_GSM7;
+
+    if (fo & 0x40) {                                        /* User data header is present */
+        if (p >= n || p + 1 + b[p] > n) {
+            return gsmERROR;
+        }
+        udhl = b[p];
+        for (i = p + 1; i + 1 < p + 1 + udhl && i + 2 + b[i + 1] <= p + 1 + udhl; i += 2 + b[i + 1]) {
+            if (b[i] == 0x00 && b[i + 1] == 3) {            /* Concatenated message, 8-bit reference */
+                pdu->Ref = b[i + 2];
+                pdu->Parts = b[i + 3];
+                pdu->Part = b[i + 4];
+            } else if (b[i] == 0x08 && b[i + 1] == 4) {     /* Concatenated message, 16-bit reference */
+                pdu->Ref = (b[i + 2] << 8) | b[i + 3];
+                pdu->Parts = b[i + 4];
+                pdu->Part = b[i + 5];
+            }
+        }
+    }
+    if (!pdu->Parts || !pdu->Part || pdu->Part > pdu->Parts) {  /* Single message */
+        pdu->Ref = 0;
+        pdu->Parts = 1;
+        pdu->Part = 1;
+    }
+
+    if (pdu->DCS == GSM_PDU_DCS_GSM7) {
+        if (p + (udl * 7 + 7) / 8 > n) {
+            return gsmERROR;
+        }
+        for (j = udl; j > 0; j--) {                         /* Unpack from the end, septet is always at or after its packed position */
+            b[p + j - 1] = Septet(&b[p], j - 1);
+        }
+        if (fo & 0x40) {
+            hdr = ((udhl + 1) * 8 + 6) / 7;                 /* Header including fill bits in septets */
+        }
+    } else {
+        if (p + udl > n) {
+            return gsmERROR;
+        }
+        if (fo & 0x40) {
+            hdr = udhl + 1;
+        }
+    }
+    if (hdr > udl) {
+        return gsmERROR;
+    }
+    pdu->Data = &b[p + hdr];
+    pdu->Length = udl - hdr;
+    return gsmOK;
+}
+
+GSM_Result_t GSM_PDU_ToUTF8(void* buff, uint16_t* len, uint16_t size, GSM_PDU_DCS_t dcs) {
+    uint8_t* b = (uint8_t *)buff;
+    uint16_t i, o, in, shift = 0;
+    uint32_t cp;
+
+    if (buff == NULL || len == NULL) {
+        return gsmPARERROR;
+    }
+    in = *len;
+    if (dcs == GSM_PDU_DCS_8BIT) {                          /* Binary data are not converted */
+        if (in >= size) {
+            return gsmERROR;
+        }
+        b[in] = 0;
+        return gsmOK;
+    }
+
+    for (i = 0, o = 0; i < in; ) {                          /* Get output length and offset needed to convert in place */
+        i += DataChar(&b[i], in - i, dcs, &cp);
+        o += UTF8Length(cp);
+        if (o > i && o - i > shift) {
+            shift = o - i;
+        }
+    }
+    if ((uint32_t)o >= size || (uint32_t)shift + in > size) {
+        return gsmERROR;
+    }
+
+    memmove(&b[shift], b, in);                              /* Move input so output never overtakes it */
+    for (i = shift, o = 0; i < shift + in; ) {
+        i += DataChar(&b[i], shift + in - i, dcs, &cp);
+        o += UTF8Put(&b[o], cp);
+    }
+    b[o] = 0;
+    *len = o;
+    return gsmOK;
+}
+
+GSM_Result_t GSM_PDU_ConcatInit(GSM_PDU_Concat_t* slot, void* buff, uint16_t size) {
+    if (slot == NULL || buff == NULL || size <= GSM_PDU_CONCAT_STRIDE) {
+        return gsmPARERROR;
+    }
+    memset(slot, 0x00, sizeof(*slot));
+    slot->Buff = (uint8_t *)buff;
+    slot->Size = size;
+    return gsmOK;
+}
+
+GSM_Result_t GSM_PDU_ConcatAdd(GSM_PDU_Concat_t* table, uint8_t count, const GSM_PDU_t* pdu, uint32_t time, GSM_PDU_Concat_t** complete) {
+    GSM_PDU_Concat_t* slot = NULL;
+    uint32_t all;
+    uint16_t len;
+    uint8_t i;
+
+    if (table == NULL || !count || pdu == NULL || complete == NULL ||
+        !pdu->Part || pdu->Part > pdu->Parts || pdu->Parts > GSM_SMS_CONCAT_PARTS) {
+        return gsmPARERROR;
+    }
+    *complete = NULL;
+
+    for (i = 0; i < count; i++) {                           /* Drop expired messages and find slot for this message */
+        if (!table[i].Parts || table[i].Completed) {
+            continue;
+        }
+        if (time - table[i].Time > GSM_SMS_CONCAT_TIMEOUT) {
+            table[i].Parts = 0;
+        } else if (pdu->Parts > 1 && table[i].Ref == pdu->Ref && table[i].Parts == pdu->Parts && strcmp(table[i].Number, pdu->Number) == 0) {
+            slot = &table[i];
+        }
+    }
+    if (slot == NULL) {                                     /* First part of new message */
+        for (i = 0; i < count && slot == NULL; i++) {
+            if (!table[i].Parts) {
+                slot = &table[i];
+            }
+        }
+        if (slot == NULL) {                                 /* Drop oldest incomplete message */
+            for (i = 0; i < count; i++) {
+                if (!table[i].Completed && (slot == NULL || time - table[i].Time > time - slot->Time)) {
+                    slot = &table[i];
+                }
+            }
+        }
+        if (slot == NULL) {                                 /* All slots hold complete messages */
+            return gsmERROR;
+        }
+        strcpy(slot->Number, pdu->Number);
+        slot->Ref = pdu->Ref;
+        slot->Parts = pdu->Parts;
+        slot->DCS = pdu->DCS;
+        slot->Received = 0;
+    }
+
+    if (pdu->Part * GSM_PDU_CONCAT_STRIDE > slot->Size || pdu->Length > GSM_PDU_CONCAT_STRIDE) {
+        slot->Parts = 0;
+        return gsmERROR;
+    }
+    memcpy(&slot->Buff[(pdu->Part - 1) * GSM_PDU_CONCAT_STRIDE], pdu->Data, pdu->Length);
+    slot->Length[pdu->Part - 1] = pdu->Length;
+    slot->Received |= 1UL << (pdu->Part - 1);
+    slot->Time = time;
+
+    all = slot->Parts >= 32 ? 0xFFFFFFFFUL : (1UL << slot->Parts) - 1;
+    if (slot->Received == all) {                            /* All parts received, join them */
+        len = 0;
+        for (i = 0; i < slot->Parts; i++) {
+            memmove(&slot->Buff[len], &slot->Buff[i * GSM_PDU_CONCAT_STRIDE], slot->Length[i]);
+            len += slot->Length[i];
+        }
+        if (GSM_PDU_ToUTF8(slot->Buff, &len, slot->Size, slot->DCS) != gsmOK) {
+            slot->Parts = 0;
+            return gsmERROR;
+        }
+        slot->Len = len;
+        slot->Completed = 1;
+        *complete = slot;
+    }
+    return gsmOK;
+}
+
+GSM_Result_t GSM_PDU_ConcatRelease(GSM_PDU_Concat_t* slot) {
+    if (slot == NULL) {
+        return gsmPARERROR;
+    }
+    slot->Parts = 0;
+    slot->Completed = 0;
+    return gsmOK;
+}
+
+#endif /* GSM_SMS && GSM_SMS_PDU */
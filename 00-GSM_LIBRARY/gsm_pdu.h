@@ -0,0 +1,188 @@
+/**
+ * \author  Tilen Majerle
+ * \email   tilen@majerle.eu
+ * \website https://majerle.eu/projects/gsm-at-commands-parser-for-embedded-systems
+ * \license MIT
+ * \brief   SMS PDU encoder, decoder and concatenated SMS reassembly
+ *
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2016 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GSM_PDU_H
+#define GSM_PDU_H 100
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gsm.h"
+
+/**
+ * \addtogroup GSM
+ * \{
+ */
+
+/**
+ * \defgroup      PDU_API
+ * \brief         SMS PDU codec used by \ref GSM_SMS_SendLong and \ref GSM_SMS_ReadPDU functions
+ * \{
+ *
+ * Encoder writes PDU as hexadecimal string directly to output function, part by part, without intermediate buffer.
+ * Decoder works in place on received hexadecimal string.
+ *
+ * Concatenated messages are reassembled in reassembly table. Each slot of table has its own buffer
+ * where parts are collected at fixed offsets of \ref GSM_PDU_CONCAT_STRIDE bytes. When all parts are received,
+ * they are joined and converted to UTF-8 in the same buffer.
+ */
+
+/**
+ * \brief         Space reserved for each part in reassembly buffer
+ */
+#define GSM_PDU_CONCAT_STRIDE           160
+
+/**
+ * \brief         Output function for encoded PDU
+ * \param[in]     *data: Pointer to hexadecimal characters
+ * \param[in]     len: Number of characters
+ * \param[in]     *arg: User argument
+ */
+typedef void (*GSM_PDU_Output_t)(const void* data, uint16_t len, void* arg);
+
+/**
+ * \brief         Slot of reassembly table for concatenated SMS
+ */
+typedef struct _GSM_PDU_Concat_t {
+    char Number[20];                                        /*!< Sender phone number */
+    uint16_t Ref;                                           /*!< Reference number of message */
+    uint8_t Parts;                                          /*!< Number of parts of message. Slot is free when set to 0 */
+    uint8_t Completed;                                      /*!< Set to 1 when all parts are received and message is joined */
+    GSM_PDU_DCS_t DCS;                                      /*!< Data coding scheme of message */
+    uint32_t Received;                                      /*!< Bit mask of received parts, bit 0 is first part */
+    uint8_t Length[GSM_SMS_CONCAT_PARTS];                   /*!< Length of each received part */
+    uint32_t Time;                                          /*!< Time when last part was received */
+    uint8_t* Buff;                                          /*!< Pointer to reassembly buffer */
+    uint16_t Size;                                          /*!< Size of reassembly buffer in units of bytes */
+    uint16_t Len;                                           /*!< Length of complete message in UTF-8 format */
+} GSM_PDU_Concat_t;
+
+/**
+ * \brief         Get number of parts needed to send message
+ * \param[in]     *text: Message in UTF-8 format
+ * \param[out]    *dcs: Pointer to save data coding scheme to. GSM 7-bit is used when all characters are in GSM alphabet
+ * \retval        Number of parts or 0 if message is too long
+ */
+uint8_t GSM_PDU_CountParts(const char* text, GSM_PDU_DCS_t* dcs);
+
+/**
+ * \brief         Get length of single part of message in PDU format
+ * \param[in]     *number: Phone number of receiver
+ * \param[in]     *text: Pointer to start of part in message
+ * \param[in]     dcs: Data coding scheme returned by \ref GSM_PDU_CountParts function
+ * \param[in]     parts: Number of parts returned by \ref GSM_PDU_CountParts function
+ * \param[out]    **end: Pointer to save end of part to. Next part starts at this position
+ * \retval        Length of TPDU in units of octets, as expected by AT+CMGS command
+ */
+uint16_t GSM_PDU_PartLength(const char* number, const char* text, GSM_PDU_DCS_t dcs, uint8_t parts, const char** end);
+
+/**
+ * \brief         Encode single part of message to PDU and write it as hexadecimal string to output function
+ * \param[in]     *number: Phone number of receiver
+ * \param[in]     *text: Pointer to start of part in message
+ * \param[in]     *end: Pointer to end of part returned by \ref GSM_PDU_PartLength function
+ * \param[in]     dcs: Data coding scheme returned by \ref GSM_PDU_CountParts function
+ * \param[in]     ref: Reference number of concatenated message
+ * \param[in]     part: Index of part, starting with 1
+ * \param[in]     parts: Number of parts returned by \ref GSM_PDU_CountParts function
+ * \param[in]     out: Output function for encoded characters
+ * \param[in]     *arg: User argument for output function
+ */
+void GSM_PDU_WritePart(const char* number, const char* text, const char* end, GSM_PDU_DCS_t dcs, uint8_t ref, uint8_t part, uint8_t parts, GSM_PDU_Output_t out, void* arg);
+
+/**
+ * \brief         Decode received SMS-DELIVER PDU in place
+ * \param[in,out] *hex: PDU as hexadecimal string. Content is overwritten with decoded data
+ * \param[out]    *pdu: Pointer to \ref GSM_PDU_t structure to save decoded message to
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_PDU_Decode(char* hex, GSM_PDU_t* pdu);
+
+/**
+ * \brief         Convert decoded user data to UTF-8 string in place
+ * \note          8-bit data are not converted, only string termination character is added
+ * \param[in,out] *buff: Pointer to user data
+ * \param[in,out] *len: Pointer to length of user data. Length of UTF-8 string is saved to it
+ * \param[in]     size: Size of buffer in units of bytes
+ * \param[in]     dcs: Data coding scheme of user data
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_PDU_ToUTF8(void* buff, uint16_t* len, uint16_t size, GSM_PDU_DCS_t dcs);
+
+/**
+ * \brief         Initialize slot of reassembly table
+ * \param[out]    *slot: Pointer to \ref GSM_PDU_Concat_t structure
+ * \param[in]     *buff: Pointer to reassembly buffer. Use at least \ref GSM_SMS_CONCAT_PARTS * \ref GSM_PDU_CONCAT_STRIDE bytes
+ *                   and more when messages are expected in UCS2 or with characters outside ASCII range
+ * \param[in]     size: Size of buffer in units of bytes
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_PDU_ConcatInit(GSM_PDU_Concat_t* slot, void* buff, uint16_t size);
+
+/**
+ * \brief         Add received message to reassembly table
+ * \note          Incomplete messages older than \ref GSM_SMS_CONCAT_TIMEOUT are dropped.
+ *                   When there is no free slot, oldest incomplete message is dropped
+ * \param[in,out] *table: Pointer to array of \ref GSM_PDU_Concat_t slots
+ * \param[in]     count: Number of slots in array
+ * \param[in]     *pdu: Pointer to message decoded with \ref GSM_SMS_ReadPDU function
+ * \param[in]     time: Current time in units of milliseconds
+ * \param[out]    **complete: Pointer to save slot with complete message to or NULL when message is not complete yet.
+ *                   Message is available in slot buffer as UTF-8 string. Release slot with \ref GSM_PDU_ConcatRelease when processed
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_PDU_ConcatAdd(GSM_PDU_Concat_t* table, uint8_t count, const GSM_PDU_t* pdu, uint32_t time, GSM_PDU_Concat_t** complete);
+
+/**
+ * \brief         Release slot with processed message
+ * \param[in,out] *slot: Pointer to \ref GSM_PDU_Concat_t structure
+ * \retval        Member of \ref GSM_Result_t enumeration
+ */
+GSM_Result_t GSM_PDU_ConcatRelease(GSM_PDU_Concat_t* slot);
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif